@@ -1,105 +1,262 @@
-import sys
+import hashlib
+import os
 import struct
+import sys
+import time
 
-Import("env")
+# Streaming Intel HEX / ELF to UF2 converter
+#
+# Used as PlatformIO extra script (post action after the .hex file is created)
+# and as command line tool:
+#   python3 create_uf2.py <input.hex|input.elf> [output.uf2]
+#   python3 create_uf2.py --bench [size in kB]
 
-# Parse input and create UF2 file
-def create_uf2(source, target, env):
-    # source_hex = target[0].get_abspath()
-    source_hex = target[0].get_string(False)
-    source_hex = '.\\'+source_hex
-    print("#########################################################")
-    print("Create UF2 from "+source_hex)
-    print("#########################################################")
-    # print("Source: " + source_hex)
-    target = source_hex.replace(".hex", "")
-    target = target + ".uf2"
-    # print("Target: " + target)
+# UF2 format taken from uf2conv.py
+UF2_MAGIC_START0 = 0x0A324655  # "UF2\n"
+UF2_MAGIC_START1 = 0x9E5D5157  # Randomly selected
+UF2_MAGIC_END = 0x0AB16F30  # Ditto
+UF2_FLAG_FAMILY_ID = 0x2000
+UF2_PAYLOAD_SIZE = 256
 
-    with open(source_hex, mode='rb') as f:
-        inpbuf = f.read()
+familyid = 0xADA52840
 
-    outbuf = convert_from_hex_to_uf2(inpbuf.decode("utf-8"))
+UF2_HEADER = struct.Struct("<IIIIIIII")
+UF2_FOOTER = struct.pack("<I", UF2_MAGIC_END)
+UF2_PADDING = bytes(512 - UF2_HEADER.size - UF2_PAYLOAD_SIZE - len(UF2_FOOTER))
 
-    write_file(target, outbuf)
-    print("#########################################################")
-    print(target + " is ready to flash to target device")
-    print("#########################################################")
 
+class ConvertError(Exception):
+    pass
 
-# Add callback after .hex file was created
-env.AddPostAction("$BUILD_DIR/${PROGNAME}.hex", create_uf2)
 
-# UF2 creation taken from uf2conv.py
-UF2_MAGIC_START0 = 0x0A324655  # "UF2\n"
-UF2_MAGIC_START1 = 0x9E5D5157  # Randomly selected
-UF2_MAGIC_END = 0x0AB16F30  # Ditto
+def hex_records(lines):
+    """Yield (address, data) of all data records, checks the checksums and the address gaps"""
+    upper = 0
+    next_addr = None
+    for line_no, line in enumerate(lines, 1):
+        line = line.strip()
+        if not line:
+            continue
+        if line[0:1] not in (":", b":"):
+            continue
+        try:
+            rec = bytes.fromhex(line[1:] if isinstance(line, str) else line[1:].decode("ascii"))
+        except ValueError:
+            raise ConvertError("Line %d: invalid hex characters" % line_no)
+        if len(rec) < 5 or len(rec) != rec[0] + 5:
+            raise ConvertError("Line %d: invalid record length" % line_no)
+        if sum(rec) & 0xFF != 0:
+            raise ConvertError("Line %d: checksum error" % line_no)
+        tp = rec[3]
+        if tp == 0:
+            addr = upper | (rec[1] << 8) | rec[2]
+            if next_addr is not None and addr != next_addr:
+                print("Address jump 0x%08X -> 0x%08X" % (next_addr, addr))
+            next_addr = addr + rec[0]
+            yield addr, rec[4:4 + rec[0]]
+        elif tp == 1:
+            return
+        elif tp == 2:
+            upper = ((rec[4] << 8) | rec[5]) << 4
+            if upper & 0xFFFF:
+                raise ConvertError("Line %d: unsupported segment address" % line_no)
+        elif tp == 4:
+            upper = ((rec[4] << 8) | rec[5]) << 16
 
-familyid = 0xADA52840
 
+def elf_records(data):
+    """Yield (address, data) of the PT_LOAD segments of an ELF32 little endian file
 
-class Block:
-    def __init__(self, addr):
-        self.addr = addr
-        self.bytes = bytearray(256)
-
-    def encode(self, blockno, numblocks):
-        global familyid
-        flags = 0x0
-        if familyid:
-            flags |= 0x2000
-        hd = struct.pack("<IIIIIIII",
-                         UF2_MAGIC_START0, UF2_MAGIC_START1,
-                         flags, self.addr, 256, blockno, numblocks, familyid)
-        hd += self.bytes[0:256]
-        while len(hd) < 512 - 4:
-            hd += b"\x00"
-        hd += struct.pack("<I", UF2_MAGIC_END)
-        return hd
+    Only the parts of the segments that are covered by allocated sections are used,
+    the first segment usually starts with the ELF headers (same result as objcopy)
+    """
+    if data[0:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        raise ConvertError("Not a 32 bit little endian ELF file")
+    (e_phoff, e_shoff) = struct.unpack_from("<II", data, 0x1C)
+    e_phentsize, e_phnum, e_shentsize, e_shnum = struct.unpack_from("<HHHH", data, 0x2A)
+    segments = []
+    for idx in range(e_phnum):
+        p_type, p_offset, p_vaddr, p_paddr, p_filesz = struct.unpack_from("<IIIII", data, e_phoff + idx * e_phentsize)
+        if p_type == 1 and p_filesz > 0:
+            segments.append((p_offset, p_filesz, p_paddr))
+    for idx in range(e_shnum):
+        sh_type, sh_flags, sh_addr, sh_offset, sh_size = struct.unpack_from("<IIIII", data, e_shoff + idx * e_shentsize + 4)
+        # Only sections with SHF_ALLOC and content (not SHT_NOBITS)
+        if sh_type == 8 or not sh_flags & 0x2 or sh_size == 0:
+            continue
+        for p_offset, p_filesz, p_paddr in segments:
+            if p_offset <= sh_offset < p_offset + p_filesz:
+                # Load address (LMA) is where the data goes into flash
+                yield p_paddr + sh_offset - p_offset, data[sh_offset:sh_offset + sh_size]
+                break
 
 
-def write_file(name, buf):
-    with open(name, "wb") as f:
-        f.write(buf)
-    # print("Wrote %d bytes to %s." % (len(buf), name))
+def convert_to_uf2(records):
+    """Collect the data into 256 byte blocks and encode them as UF2"""
+    blocks = {}
+    written = {}
+    for addr, data in records:
+        pos = 0
+        while pos < len(data):
+            block_addr = (addr + pos) & ~0xFF
+            offset = (addr + pos) & 0xFF
+            chunk = min(len(data) - pos, UF2_PAYLOAD_SIZE - offset)
+            block = blocks.get(block_addr)
+            if block is None:
+                block = blocks[block_addr] = bytearray(UF2_PAYLOAD_SIZE)
+                written[block_addr] = bytearray(UF2_PAYLOAD_SIZE)
+            mask = written[block_addr]
+            if any(mask[offset:offset + chunk]):
+                raise ConvertError("Data overlap at 0x%08X" % (addr + pos))
+            mask[offset:offset + chunk] = b"\x01" * chunk
+            block[offset:offset + chunk] = data[pos:pos + chunk]
+            pos += chunk
+
+    flags = UF2_FLAG_FAMILY_ID if familyid else 0
+    numblocks = len(blocks)
+    out = []
+    for blockno, block_addr in enumerate(sorted(blocks)):
+        out.append(UF2_HEADER.pack(UF2_MAGIC_START0, UF2_MAGIC_START1, flags, block_addr,
+                                   UF2_PAYLOAD_SIZE, blockno, numblocks, familyid))
+        out.append(blocks[block_addr])
+        out.append(UF2_PADDING)
+        out.append(UF2_FOOTER)
+    return b"".join(out)
+
+
+def convert_file(source, target, hash_file=None):
+    """Convert HEX or ELF file to UF2, skip if the input did not change since the last run"""
+    with open(source, "rb") as f:
+        inpbuf = f.read()
+
+    digest = hashlib.sha256(inpbuf).hexdigest()
+    if hash_file and os.path.exists(target) and os.path.exists(hash_file):
+        with open(hash_file, "r") as f:
+            if f.read().strip() == digest:
+                print(target + " is up to date")
+                return False
+
+    if inpbuf[0:4] == b"\x7fELF":
+        outbuf = convert_to_uf2(elf_records(inpbuf))
+    else:
+        outbuf = convert_to_uf2(hex_records(inpbuf.splitlines()))
+
+    with open(target, "wb") as f:
+        f.write(outbuf)
+    if hash_file:
+        with open(hash_file, "w") as f:
+            f.write(digest)
+    return True
 
 
-def convert_from_hex_to_uf2(buf):
-    global appstartaddr
-    appstartaddr = None
+# Parse input and create UF2 file
+def create_uf2(source, target, env):
+    source_hex = target[0].get_abspath()
+    print("#########################################################")
+    print("Create UF2 from " + source_hex)
+    print("#########################################################")
+    target = os.path.splitext(source_hex)[0] + ".uf2"
+    hash_file = os.path.join(env.subst("$BUILD_DIR"), "uf2_source.sha256")
+
+    try:
+        convert_file(source_hex, target, hash_file)
+    except ConvertError as err:
+        print("UF2 conversion failed: " + str(err))
+        env.Exit(1)
+
+    print("#########################################################")
+    print(target + " is ready to flash to target device")
+    print("#########################################################")
+
+
+def legacy_convert_from_hex_to_uf2(buf):
+    """Previous character by character converter, only kept for the benchmark"""
     upper = 0
     currblock = None
     blocks = []
-    for line in buf.split('\n'):
-        if line[0] != ":":
+    for line in buf.split("\n"):
+        if line[0:1] != ":":
             continue
         i = 1
         rec = []
         while i < len(line) - 1:
-            rec.append(int(line[i:i+2], 16))
+            rec.append(int(line[i:i + 2], 16))
             i += 2
         tp = rec[3]
         if tp == 4:
             upper = ((rec[4] << 8) | rec[5]) << 16
         elif tp == 2:
             upper = ((rec[4] << 8) | rec[5]) << 4
-            assert (upper & 0xffff) == 0
         elif tp == 1:
             break
         elif tp == 0:
             addr = upper | (rec[1] << 8) | rec[2]
-            if appstartaddr == None:
-                appstartaddr = addr
             i = 4
             while i < len(rec) - 1:
-                if not currblock or currblock.addr & ~0xff != addr & ~0xff:
-                    currblock = Block(addr & ~0xff)
+                if not currblock or currblock[0] & ~0xff != addr & ~0xff:
+                    currblock = (addr & ~0xff, bytearray(256))
                     blocks.append(currblock)
-                currblock.bytes[addr & 0xff] = rec[i]
+                currblock[1][addr & 0xff] = rec[i]
                 addr += 1
                 i += 1
     numblocks = len(blocks)
     resfile = b""
     for i in range(0, numblocks):
-        resfile += blocks[i].encode(i, numblocks)
+        hd = UF2_HEADER.pack(UF2_MAGIC_START0, UF2_MAGIC_START1, UF2_FLAG_FAMILY_ID,
+                             blocks[i][0], 256, i, numblocks, familyid)
+        hd += blocks[i][1]
+        while len(hd) < 512 - 4:
+            hd += b"\x00"
+        hd += UF2_FOOTER
+        resfile += hd
     return resfile
+
+
+def benchmark(size_kb):
+    """Compare old and new converter on a synthetic image"""
+    lines = [":020000040000FA"]
+    addr = 0x26000
+    upper = 0
+    for idx in range(size_kb * 1024 // 16):
+        if (addr >> 16) != upper:
+            upper = addr >> 16
+            rec = bytes([2, 0, 0, 4, upper >> 8, upper & 0xFF])
+            lines.append(":" + (rec + bytes([-sum(rec) & 0xFF])).hex().upper())
+        data = bytes((idx + pos) & 0xFF for pos in range(16))
+        rec = bytes([16, (addr >> 8) & 0xFF, addr & 0xFF, 0]) + data
+        lines.append(":" + (rec + bytes([-sum(rec) & 0xFF])).hex().upper())
+        addr += 16
+    lines.append(":00000001FF")
+    text = "\n".join(lines)
+
+    start = time.perf_counter()
+    new = convert_to_uf2(hex_records(text.splitlines()))
+    new_time = time.perf_counter() - start
+    start = time.perf_counter()
+    old = legacy_convert_from_hex_to_uf2(text)
+    old_time = time.perf_counter() - start
+
+    print("Image %d kB, %d UF2 blocks" % (size_kb, len(new) // 512))
+    print("old converter: %8.3f s" % old_time)
+    print("new converter: %8.3f s (%.1fx faster)" % (new_time, old_time / new_time))
+    print("output identical: %s" % (new == old))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) >= 2 and sys.argv[1] == "--bench":
+        benchmark(int(sys.argv[2]) if len(sys.argv) > 2 else 800)
+    elif len(sys.argv) >= 2:
+        source = sys.argv[1]
+        target = sys.argv[2] if len(sys.argv) > 2 else os.path.splitext(source)[0] + ".uf2"
+        try:
+            convert_file(source, target)
+        except ConvertError as err:
+            sys.exit("UF2 conversion failed: " + str(err))
+        print(target + " created")
+    else:
+        sys.exit("Usage: create_uf2.py <input.hex|input.elf> [output.uf2] | --bench [size in kB]")
+else:
+    Import("env")
+
+    # Add callback after .hex file was created
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.hex", create_uf2)
@@ -0,0 +1,108 @@
+# RAM report of the firmware, runs after the .elf was linked
+#
+# Prints the size of .data, .bss, heap and stack from the linker symbols and
+# the largest static variables, so the headroom for more tests is visible.
+# The code size of the fmt formatter is compared with the newlib printf core
+# and its float part (_printf_float, _dtoa_r and the soft double functions).
+# Standalone: python3 ram_report.py Generated/WB_HW_Test_V1.1.6.elf [number of symbols]
+
+import os
+import struct
+import sys
+
+SHT_SYMTAB = 2
+STT_OBJECT = 1
+STT_FUNC = 2
+
+# newlib printf core
+PRINTF_CORE = ("_vfprintf_r", "_svfprintf_r", "_vfiprintf_r", "_svfiprintf_r", "_printf_i", "_printf_common")
+# Pulled in by %f, the double math is used by the float conversions of the callers too
+PRINTF_FLOAT = ("_printf_float", "_dtoa_r", "__cvt", "__exponent", "__d2b", "_Balloc", "_Bfree", "__multadd",
+                "__i2b", "__multiply", "__pow5mult", "__lshift", "__mcmp", "__mdiff", "__hi0bits", "__lo0bits",
+                "__b2d", "__ratio", "_mprec_log10", "__adddf3", "__subdf3", "__muldf3", "__divdf3",
+                "__floatsidf", "__floatunsidf", "__extendsfdf2", "__truncdfsf2", "__fixdfsi", "__fixunsdfsi",
+                "__eqdf2", "__nedf2", "__ltdf2", "__gtdf2", "__ledf2", "__gedf2", "__unorddf2")
+
+
+def elf_symbols(data):
+    """Return a dict name -> (value, size, type) of all symbols of a 32 bit little endian ELF"""
+    if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        raise ValueError("not a 32 bit little endian ELF file")
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+    sections = [struct.unpack_from("<IIIIIIIIII", data, shoff + idx * shentsize) for idx in range(shnum)]
+    symbols = {}
+    for section in sections:
+        if section[1] != SHT_SYMTAB:
+            continue
+        strtab = sections[section[6]][4]
+        for offset in range(section[4], section[4] + section[5], 16):
+            name, value, size, info, _, _ = struct.unpack_from("<IIIBBH", data, offset)
+            end = data.index(b"\0", strtab + name)
+            symbols[data[strtab + name:end].decode(errors="replace")] = (value, size, info & 0x0F)
+    return symbols
+
+
+def ram_report(elf_file, top=15):
+    with open(elf_file, "rb") as f:
+        symbols = elf_symbols(f.read())
+
+    def addr(name):
+        return symbols[name][0] if name in symbols else 0
+
+    data_size = addr("__data_end__") - addr("__data_start__")
+    bss_size = addr("__bss_end__") - addr("__bss_start__")
+    heap_size = addr("__HeapLimit") - addr("__HeapBase")
+    stack_size = addr("__StackTop") - addr("__StackLimit")
+    print("RAM report %s" % os.path.basename(elf_file))
+    print("  .data %7d bytes" % data_size)
+    print("  .bss  %7d bytes" % bss_size)
+    print("  heap  %7d bytes (FreeRTOS task stacks and display arena are taken from here)" % heap_size)
+    print("  stack %7d bytes (main stack, used by interrupts)" % stack_size)
+
+    start, end = addr("__data_start__"), addr("__bss_end__")
+    statics = sorted(((size, name) for name, (value, size, kind) in symbols.items()
+                      if kind == STT_OBJECT and start <= value < end and size > 0), reverse=True)
+    print("  largest static variables:")
+    for size, name in statics[:top]:
+        print("  %7d %s" % (size, name))
+
+
+def code_size(symbols, match):
+    """Sum of the sizes of the functions that match, aliases at the same address are counted once"""
+    found = {}
+    for name, (value, size, kind) in symbols.items():
+        if kind == STT_FUNC and size > 0 and match(name):
+            found[value] = size
+    return sum(found.values()), len(found)
+
+
+def fmt_report(elf_file):
+    with open(elf_file, "rb") as f:
+        symbols = elf_symbols(f.read())
+
+    fmt_size, fmt_num = code_size(symbols, lambda name: "fmt_" in name)
+    core_size, core_num = code_size(symbols, lambda name: name in PRINTF_CORE)
+    float_size, float_num = code_size(symbols, lambda name: name in PRINTF_FLOAT)
+    print("Formatter code size %s" % os.path.basename(elf_file))
+    print("  fmt            %7d bytes in %d functions" % (fmt_size, fmt_num))
+    print("  printf core    %7d bytes in %d functions" % (core_size, core_num))
+    print("  printf float   %7d bytes in %d functions" % (float_size, float_num))
+    if float_size != 0:
+        print("  float printf is still linked, a %f or a double argument is left somewhere (library or Serial.printf)")
+
+
+def post_build(source, target, env):
+    ram_report(str(source[0]))
+    fmt_report(str(source[0]))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        sys.exit("Usage: ram_report.py <firmware.elf> [number of symbols]")
+    ram_report(sys.argv[1], int(sys.argv[2]) if len(sys.argv) > 2 else 15)
+    fmt_report(sys.argv[1])
+else:
+    Import("env")
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", post_build)
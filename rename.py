@@ -1,4 +1,5 @@
 import datetime
+import os
 
 Import("env")
 
@@ -12,4 +13,10 @@ version_tag_2 = defines.get("SW_VERSION_2")
 version_tag_3 = defines.get("SW_VERSION_3")
 build_date = datetime.datetime.now().strftime('%Y.%m.%d.%H.%M.%S')
 
-env.Replace(PROGNAME="../../../Generated/WB_HW_Test_V%s.%s.%s" % (version_tag_1,version_tag_2,version_tag_3))
+# PROGNAME is relative to the build folder, point it to <project>/Generated
+generated_dir = os.path.join(env.subst("$PROJECT_DIR"), "Generated")
+if not os.path.isdir(generated_dir):
+    os.makedirs(generated_dir)
+generated_rel = os.path.relpath(generated_dir, env.subst("$BUILD_DIR"))
+
+env.Replace(PROGNAME=os.path.join(generated_rel, "WB_HW_Test_V%s.%s.%s" % (version_tag_1, version_tag_2, version_tag_3)).replace("\\", "/"))
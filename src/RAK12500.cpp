@@ -39,6 +39,7 @@ int32_t altitude = 0;
 int32_t accuracy = 0;
 
 byte fix_type = 0; // Get the fix type
+uint8_t last_sat_num = 0; // Satellites of the last poll
 char fix_type_str[32] = {0};
 
 /**
@@ -57,10 +58,12 @@ bool init_gnss(void)
 	// Give the module some time to power up
 	delay(500);
 
+	i2c_bus_take(0x42);
 	if (gnss_option == NO_GNSS_INIT)
 	{
 		if (!my_gnss.begin())
 		{
+			i2c_bus_give();
 			MYLOG("GNSS", "UBLOX did not answer on I2C, retry on Serial1");
 			return false;
 		}
@@ -90,6 +93,7 @@ bool init_gnss(void)
 
 			my_gnss.saveConfiguration(); // Save the current settings to flash and BBR
 
+			i2c_bus_give();
 			return true;
 		}
 	}
@@ -113,6 +117,7 @@ bool init_gnss(void)
 
 			my_gnss.saveConfiguration(); // Save the current settings to flash and BBR
 		}
+		i2c_bus_give();
 		return true;
 	}
 }
@@ -125,6 +130,7 @@ bool init_gnss(void)
  */
 bool poll_gnss(void)
 {
+	TRACE_SCOPE("poll_gnss");
 	char oled_buff[128];
 
 	MYLOG("GNSS", "poll_gnss");
@@ -143,12 +149,15 @@ bool poll_gnss(void)
 	sprintf(fix_type_str, "None");
 	while ((millis() - time_out) < check_limit)
 	{
+		i2c_bus_take(0x42);
 		latitude = my_gnss.getLatitude();
 		longitude = my_gnss.getLongitude();
 		altitude = my_gnss.getAltitude();
 		accuracy = my_gnss.getHorizontalDOP();
 		sat_num = my_gnss.getSIV();
 		fix_type = my_gnss.getFixType(); // Get the fix type
+		i2c_bus_give();
+		last_sat_num = sat_num;
 		if (fix_type == 1)
 			sprintf(fix_type_str, "Dead reckoning");
 		else if (fix_type == 2)
@@ -166,9 +175,12 @@ bool poll_gnss(void)
 		}
 
 		MYLOG("GNSS", "Sat: %d Fix: %s", sat_num, fix_type_str);
-		MYLOG("GNSS", "Lat: %.4f Lon: %.4f", latitude / 10000000.0, longitude / 10000000.0);
-		MYLOG("GNSS", "Alt: %.2f", altitude / 1000.0);
-		MYLOG("GNSS", "HDOP: %.2f ", accuracy / 100.0);
+		FMT(oled_buff, sizeof(oled_buff), "Lat: %.4f Lon: %.4f", fmt_fix((int32_t)latitude, 7), fmt_fix((int32_t)longitude, 7));
+		MYLOG("GNSS", "%s", oled_buff);
+		FMT(oled_buff, sizeof(oled_buff), "Alt: %.2f", fmt_fix(altitude, 3));
+		MYLOG("GNSS", "%s", oled_buff);
+		FMT(oled_buff, sizeof(oled_buff), "HDOP: %.2f ", fmt_fix(accuracy, 2));
+		MYLOG("GNSS", "%s", oled_buff);
 
 		if ((accuracy < 300) && (sat_num > 5))
 		{
@@ -240,9 +252,9 @@ bool poll_gnss(void)
 		{
 			snprintf(oled_buff, 127, "Fix: %s Sat: %d", fix_type_str, sat_num);
 			rak1921_add_line(oled_buff);
-			snprintf(oled_buff, 127, "L: %.6f:%.6f", latitude / 10000000.0, longitude / 10000000.0);
+			FMT(oled_buff, 127, "L: %.6f:%.6f", fmt_fix((int32_t)latitude, 7), fmt_fix((int32_t)longitude, 7));
 			rak1921_add_line(oled_buff);
-			snprintf(oled_buff, 127, "Alt: %.2f, Acry %.2f", altitude / 1000.0, accuracy / 100.0);
+			FMT(oled_buff, 127, "Alt: %.2f, Acry %.2f", fmt_fix(altitude, 3), fmt_fix(accuracy, 2));
 			rak1921_add_line(oled_buff);
 		}
 		return true;
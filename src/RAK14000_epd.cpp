@@ -9,26 +9,77 @@
  *
  */
 #include "main.h"
+#include <new>
 
 #include <rak14000.h> //Click here to get the library: http://librarymanager/All#RAK14000
 
 #include "RAK14000_epd.h"
+#include "epd_blit.h"
 
 #define LEFT_BUTTON WB_IO6
 #define MIDDLE_BUTTON WB_IO5
 #define RIGHT_BUTTON WB_IO3
 
-char disp_text[60];
-
-unsigned char image[4000];
+/** Display buffer, claimed when the EPD is detected */
+unsigned char *image = NULL;
 EPD_213_BW epd;
-Paint paint(image, 122, 250);
+/** Paint object on the display buffer, created when the EPD is detected */
+Paint *paint = NULL;
 
 uint16_t bg_color = UNCOLORED;
 uint16_t txt_color = COLORED;
 
+/** Flag to draw text with the blitter, false to use Paint::DrawStringAt() */
+bool epd_use_blit = true;
+
+/** Position of a result field on the EPD and the text shown */
+struct epd_slot_s
+{
+	result_field_e field;
+	int16_t y;
+	char text[24];
+};
+
+/** Result fields shown on the EPD */
+static epd_slot_s epd_slots[] = {
+	{RESULT_FLASH, 30, ""},
+	{RESULT_TX, 50, ""},
+	{RESULT_OLED, 70, ""},
+	{RESULT_BATT, 90, ""},
+};
+
+/** X position of the result fields */
+#define EPD_SLOT_X 70
+
+/** Flag if the display buffer holds the result screen */
+static bool epd_composed = false;
+
 void rak14000_text(int16_t x, int16_t y, char *text, uint16_t text_color, uint32_t text_size);
 
+/**
+ * @brief Claim the display buffer and create the Paint object
+ *
+ * @return true if the buffers are available
+ * @return false if there is not enough memory
+ */
+bool rak14000_alloc(void)
+{
+	if (paint != NULL)
+	{
+		return true;
+	}
+	// One claim for both, the arena never frees, a half done claim would be lost
+	void *epd_mem = disp_arena_claim(sizeof(Paint) + EPD_BUFFER_SIZE, "EPD image+paint");
+	if (epd_mem == NULL)
+	{
+		return false;
+	}
+	// Paint first, calloc aligns it, the image is a byte array
+	image = (unsigned char *)epd_mem + sizeof(Paint);
+	paint = new (epd_mem) Paint(image, 122, 250);
+	return true;
+}
+
 bool init_rak14000(void)
 {
 	digitalWrite(POWER_ENABLE, HIGH);
@@ -54,20 +105,26 @@ bool init_rak14000(void)
 		return false;
 	}
 
+	if (!rak14000_alloc())
+	{
+		return false;
+	}
+
 	clear_rak14000();
-	// paint.drawBitmap(5, 5, (uint8_t *)rak_img, 59, 56);
+	// paint->drawBitmap(5, 5, (uint8_t *)rak_img, 59, 56);
 	rak14000_logo(5, 5);
 	rak14000_text(60, 65, (char *)"RAKWireless", (uint16_t)txt_color, 2);
 	rak14000_text(60, 85, (char *)"IoT Made Easy", (uint16_t)txt_color, 2);
 
 	epd.Display(image);
+	epd_composed = false;
 	delay(500);
 	return true;
 }
 
 void rak14000_logo(int16_t x, int16_t y)
 {
-	paint.drawBitmap(x, y, (uint8_t *)rak_img, 59, 56);
+	paint->drawBitmap(x, y, (uint8_t *)rak_img, 59, 56);
 }
 
 /**
@@ -90,60 +147,144 @@ void rak14000_text(int16_t x, int16_t y, char *text, uint16_t text_color, uint32
 	{
 		use_font = &Font20;
 	}
-	paint.DrawStringAt(x, y, text, use_font, COLORED);
+	if (epd_use_blit)
+	{
+		epd_blit_string(x, y, text, use_font);
+	}
+	else
+	{
+		paint->DrawStringAt(x, y, text, use_font, COLORED);
+	}
 }
 
 void clear_rak14000(void)
 {
-	paint.SetRotate(ROTATE_270);
+	paint->SetRotate(ROTATE_270);
+	// Measure the buffer layout once for the text blitter
+	epd_blit_init(paint, image, EPD_BUFFER_SIZE);
 	epd.Init(FULL);
 	// epd.Clear();
-	paint.Clear(UNCOLORED);
+	paint->Clear(UNCOLORED);
+}
+
+/**
+ * @brief Format the text of a result field
+ *
+ * @param field result field
+ * @param buff buffer for the text
+ * @param buff_size size of the buffer
+ */
+static void epd_field_text(result_field_e field, char *buff, size_t buff_size)
+{
+	int32_t value = result_get(field);
+	switch (field)
+	{
+	case RESULT_FLASH:
+		snprintf(buff, buff_size, "Flash R/W %s", value ? "OK" : "NOK");
+		break;
+	case RESULT_TX:
+		snprintf(buff, buff_size, "%s", value == 0 ? "LoRa OK" : (value == 1 ? "LoRa failed" : "LoRa test"));
+		break;
+	case RESULT_OLED:
+		snprintf(buff, buff_size, "OLED %s", value ? "OK" : "NA");
+		break;
+	case RESULT_BATT:
+		FMT(buff, buff_size, "Batt %.2fV", fmt_fix(value, 3));
+		break;
+	default:
+		buff[0] = 0;
+		break;
+	}
 }
 
+/**
+ * @brief Redraw the complete result screen and refresh the EPD
+ *
+ */
 void refresh_rak14000(void)
 {
+	TRACE_SCOPE("epd_refresh");
+
 	// Clear display buffer
 	clear_rak14000();
 
-	paint.Clear(UNCOLORED);
-	rak14000_text(0, 4, (char *)"RAK Test Firmware", txt_color, 2);
+	compose_rak14000();
 
-	rak14000_logo(0, 31);
+	epd.Init(FULL);
+	epd.Display(image);
+}
 
-	snprintf(disp_text, 59, "Flash R/W %s", flash_success ? "OK" : "NOK");
-	rak14000_text(70, 30, disp_text, (uint16_t)txt_color, 2);
+/**
+ * @brief Result model view, redraws only the fields that changed their text
+ * 		The EPD is refreshed only if a shown field changed
+ *
+ * @param changed mask of the changed result fields
+ */
+void rak14000_result_view(uint32_t changed)
+{
+	if (!epd_composed)
+	{
+		refresh_rak14000();
+		return;
+	}
 
-	switch (lora_success)
+	bool dirty = false;
+	char text[sizeof(epd_slots[0].text)];
+	for (uint8_t idx = 0; idx < sizeof(epd_slots) / sizeof(epd_slots[0]); idx++)
 	{
-	case 0:
-		snprintf(disp_text, 59, "LoRa OK");
-		rak14000_text(70, 50, disp_text, (uint16_t)txt_color, 2);
-		break;
-	case 1:
-		snprintf(disp_text, 59, "LoRa failed");
-		rak14000_text(70, 50, disp_text, (uint16_t)txt_color, 2);
-		break;
-	case 2:
-		snprintf(disp_text, 59, "LoRa test");
-		rak14000_text(70, 50, disp_text, (uint16_t)txt_color, 2);
-		break;
+		epd_slot_s *slot = &epd_slots[idx];
+		if ((changed & RESULT_BIT(slot->field)) == 0)
+		{
+			continue;
+		}
+		epd_field_text(slot->field, text, sizeof(text));
+		if (strcmp(text, slot->text) == 0)
+		{
+			continue;
+		}
+		strcpy(slot->text, text);
+		paint->DrawFilledRectangle(EPD_SLOT_X, slot->y, paint->GetHeight() - 1, slot->y + Font20.Height - 1, UNCOLORED);
+		rak14000_text(EPD_SLOT_X, slot->y, slot->text, (uint16_t)txt_color, 2);
+		dirty = true;
 	}
 
-	snprintf(disp_text, 59, "OLED %s", has_rak1921 ? "OK" : "NA");
-	rak14000_text(70, 70, disp_text, (uint16_t)txt_color, 2);
+	if (dirty)
+	{
+		TRACE_SCOPE("epd_refresh");
+		epd.Init(FULL);
+		epd.Display(image);
+	}
+}
 
-	// Get Battery status
-	float batt_level_f = 0.0;
-	for (int readings = 0; readings < 10; readings++)
+/**
+ * @brief Get the CRC-32 of the display buffer
+ *
+ * @return uint32_t CRC-32 of the buffer, 0 if the buffer is not allocated
+ */
+uint32_t rak14000_crc(void)
+{
+	if (image == NULL)
 	{
-		batt_level_f += read_batt();
+		return 0;
 	}
-	batt_level_f = batt_level_f / 10;
+	return crc32_update(CRC32_INIT, image, EPD_BUFFER_SIZE);
+}
 
-	snprintf(disp_text, 59, "Batt %.2fV", batt_level_f/1000);
-	rak14000_text(70, 90, disp_text, (uint16_t)txt_color, 2);
+/**
+ * @brief Draw the test results into the display buffer
+ *
+ */
+void compose_rak14000(void)
+{
+	paint->Clear(UNCOLORED);
+	rak14000_text(0, 4, (char *)"RAK Test Firmware", txt_color, 2);
 
-	epd.Init(FULL);
-	epd.Display(image);
+	rak14000_logo(0, 31);
+
+	for (uint8_t idx = 0; idx < sizeof(epd_slots) / sizeof(epd_slots[0]); idx++)
+	{
+		epd_field_text(epd_slots[idx].field, epd_slots[idx].text, sizeof(epd_slots[idx].text));
+		rak14000_text(EPD_SLOT_X, epd_slots[idx].y, epd_slots[idx].text, (uint16_t)txt_color, 2);
+	}
+	epd_composed = true;
 }
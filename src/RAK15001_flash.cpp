@@ -0,0 +1,258 @@
+/**
+ * @file RAK15001_flash.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Detection and throughput test of a SPI NOR flash (RAK15001) in the SPI slot
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The chip is found by its JEDEC ID (0x9F). The test erases the last 64 kB
+ * block of the chip (the first 16 MB on larger chips), programs it page by
+ * page with a pseudo random pattern and reads it back with fast read.
+ * Data is sent with the buffer transfer of the SPI class, which uses the
+ * EasyDMA of the SPIM. The slot has only MOSI and MISO, quad mode is not
+ * possible. The RAK14000 uses the same slot, the test is skipped if it was found.
+ */
+#include "main.h"
+#include <SPI.h>
+
+/** SPI NOR commands */
+#define SFLASH_CMD_WREN 0x06
+#define SFLASH_CMD_RDSR 0x05
+#define SFLASH_CMD_JEDEC 0x9F
+#define SFLASH_CMD_RELEASE_PD 0xAB
+#define SFLASH_CMD_ERASE_64K 0xD8
+#define SFLASH_CMD_PROGRAM 0x02
+#define SFLASH_CMD_FAST_READ 0x0B
+
+/** Status register busy bit */
+#define SFLASH_SR_WIP 0x01
+/** Size of the test area, one 64 kB block */
+#define SFLASH_TEST_SIZE 0x10000
+/** Program page size */
+#define SFLASH_PAGE 256
+/** Max time for a block erase (datasheet max is ~2 s) */
+#define SFLASH_ERASE_TIMEOUT 3000
+/** Max time for a page program */
+#define SFLASH_PROGRAM_TIMEOUT 10
+
+/** Flag if a SPI flash was found */
+bool has_rak15001 = false;
+
+/** Results of the last test */
+static sflash_result_s sflash_result;
+
+/** Page buffer */
+static uint8_t sflash_page[SFLASH_PAGE];
+
+static const SPISettings sflash_spi(SFLASH_SPI_CLOCK, MSBFIRST, SPI_MODE0);
+
+/**
+ * @brief Send a command with a 24 bit address
+ *
+ * @param cmd command
+ * @param addr address
+ */
+static void sflash_cmd_addr(uint8_t cmd, uint32_t addr)
+{
+	uint8_t header[4] = {cmd, (uint8_t)(addr >> 16), (uint8_t)(addr >> 8), (uint8_t)addr};
+	SPI.transfer(header, NULL, sizeof(header));
+}
+
+/**
+ * @brief Send a single byte command
+ *
+ * @param cmd command
+ */
+static void sflash_cmd(uint8_t cmd)
+{
+	SPI.beginTransaction(sflash_spi);
+	digitalWrite(SS, LOW);
+	SPI.transfer(cmd);
+	digitalWrite(SS, HIGH);
+	SPI.endTransaction();
+}
+
+/**
+ * @brief Wait until an erase or program is finished
+ *
+ * @param timeout max time in ms
+ * @return true if finished
+ * @return false on timeout
+ */
+static bool sflash_wait(uint32_t timeout)
+{
+	uint32_t start = millis();
+	SPI.beginTransaction(sflash_spi);
+	digitalWrite(SS, LOW);
+	SPI.transfer(SFLASH_CMD_RDSR);
+	bool ready = false;
+	// The status register is sent repeatedly while CS is low
+	while (!ready && ((millis() - start) <= timeout))
+	{
+		ready = (SPI.transfer(0xFF) & SFLASH_SR_WIP) == 0;
+	}
+	digitalWrite(SS, HIGH);
+	SPI.endTransaction();
+	return ready;
+}
+
+/**
+ * @brief Fill the page buffer with the test pattern
+ *
+ * @param page page number, seed of the pattern
+ */
+static void sflash_pattern(uint32_t page)
+{
+	uint32_t state = 0x9E3779B9 ^ (page * 0x85EBCA6B);
+	for (uint16_t idx = 0; idx < SFLASH_PAGE; idx += 4)
+	{
+		// xorshift32
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		memcpy(&sflash_page[idx], &state, 4);
+	}
+}
+
+/**
+ * @brief Throughput in MB/s x 1000
+ *
+ * @param bytes number of bytes
+ * @param time_us time in us
+ * @return uint32_t MB/s x 1000
+ */
+static uint32_t sflash_rate(uint32_t bytes, uint32_t time_us)
+{
+	return time_us == 0 ? 0 : (uint32_t)((uint64_t)bytes * 1000 / time_us);
+}
+
+/**
+ * @brief Check the SPI slot for a flash chip
+ *
+ * @return true if a chip answered with a valid JEDEC ID
+ * @return false if no chip was found
+ */
+bool init_rak15001(void)
+{
+	memset(&sflash_result, 0, sizeof(sflash_result));
+	if (has_rak14000)
+	{
+		// Same slot, same CS
+		return false;
+	}
+	pinMode(SS, OUTPUT);
+	digitalWrite(SS, HIGH);
+	SPI.begin();
+
+	// Wake up from deep power down
+	sflash_cmd(SFLASH_CMD_RELEASE_PD);
+	delay(1);
+
+	uint8_t jedec[4] = {SFLASH_CMD_JEDEC, 0xFF, 0xFF, 0xFF};
+	SPI.beginTransaction(sflash_spi);
+	digitalWrite(SS, LOW);
+	SPI.transfer(jedec, sizeof(jedec));
+	digitalWrite(SS, HIGH);
+	SPI.endTransaction();
+
+	sflash_result.jedec_id = ((uint32_t)jedec[1] << 16) | ((uint32_t)jedec[2] << 8) | jedec[3];
+	// No chip: MISO floats high or is pulled low, capacity code out of range
+	if ((jedec[1] == 0x00) || (jedec[1] == 0xFF) || (jedec[3] < 0x10) || (jedec[3] > 0x20))
+	{
+		SPI.end();
+		return false;
+	}
+	sflash_result.size = 1UL << jedec[3];
+	return true;
+}
+
+/**
+ * @brief Erase, program and read back the last 64 kB block
+ *
+ * @return true if the data read back matches the data written
+ * @return false on timeout or CRC mismatch
+ */
+bool rak15001_throughput(void)
+{
+	// 3 byte addresses reach 16 MB
+	uint32_t area = (sflash_result.size > 0x1000000 ? 0x1000000 : sflash_result.size) - SFLASH_TEST_SIZE;
+	bool ok = true;
+
+	// Erase
+	uint32_t start = micros();
+	sflash_cmd(SFLASH_CMD_WREN);
+	SPI.beginTransaction(sflash_spi);
+	digitalWrite(SS, LOW);
+	sflash_cmd_addr(SFLASH_CMD_ERASE_64K, area);
+	digitalWrite(SS, HIGH);
+	SPI.endTransaction();
+	ok &= sflash_wait(SFLASH_ERASE_TIMEOUT);
+	sflash_result.erase_us = micros() - start;
+
+	// Program, the pattern is created between the pages while the chip is busy
+	uint32_t crc_written = CRC32_INIT;
+	start = micros();
+	for (uint32_t page = 0; ok && (page < SFLASH_TEST_SIZE / SFLASH_PAGE); page++)
+	{
+		sflash_pattern(page);
+		crc_written = crc32_update(crc_written, sflash_page, SFLASH_PAGE);
+		sflash_cmd(SFLASH_CMD_WREN);
+		SPI.beginTransaction(sflash_spi);
+		digitalWrite(SS, LOW);
+		sflash_cmd_addr(SFLASH_CMD_PROGRAM, area + page * SFLASH_PAGE);
+		SPI.transfer(sflash_page, NULL, SFLASH_PAGE);
+		digitalWrite(SS, HIGH);
+		SPI.endTransaction();
+		ok &= sflash_wait(SFLASH_PROGRAM_TIMEOUT);
+	}
+	sflash_result.program_us = micros() - start;
+
+	// Fast read of the whole block in one transaction
+	uint32_t crc_read = CRC32_INIT;
+	start = micros();
+	SPI.beginTransaction(sflash_spi);
+	digitalWrite(SS, LOW);
+	sflash_cmd_addr(SFLASH_CMD_FAST_READ, area);
+	SPI.transfer(0xFF); // dummy byte
+	for (uint32_t page = 0; page < SFLASH_TEST_SIZE / SFLASH_PAGE; page++)
+	{
+		SPI.transfer(NULL, sflash_page, SFLASH_PAGE);
+		crc_read = crc32_update(crc_read, sflash_page, SFLASH_PAGE);
+	}
+	digitalWrite(SS, HIGH);
+	SPI.endTransaction();
+	sflash_result.read_us = micros() - start;
+
+	sflash_result.crc_ok = ok && (crc_read == crc_written);
+	sflash_result.tested = true;
+	SPI.end();
+	return sflash_result.crc_ok;
+}
+
+/**
+ * @brief Create a compact line with the result of the SPI flash test
+ * 		Format: ID=<JEDEC ID>,SIZE=<kB>,ERASE=<MB/s>,PROG=<MB/s>,READ=<MB/s>,CRC=<OK|FAIL> or NONE
+ * 		The read rate includes the CRC calculation
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void rak15001_report(char *buff, size_t buff_size)
+{
+	if (sflash_result.size == 0)
+	{
+		FMT(buff, buff_size, "NONE");
+		return;
+	}
+	if (!sflash_result.tested)
+	{
+		FMT(buff, buff_size, "ID=%06lX,SIZE=%lu", sflash_result.jedec_id, sflash_result.size / 1024);
+		return;
+	}
+	FMT(buff, buff_size, "ID=%06lX,SIZE=%lu,ERASE=%.3f,PROG=%.3f,READ=%.3f,CRC=%s", sflash_result.jedec_id,
+		sflash_result.size / 1024, fmt_fix(sflash_rate(SFLASH_TEST_SIZE, sflash_result.erase_us), 3),
+		fmt_fix(sflash_rate(SFLASH_TEST_SIZE, sflash_result.program_us), 3),
+		fmt_fix(sflash_rate(SFLASH_TEST_SIZE, sflash_result.read_us), 3), sflash_result.crc_ok ? "OK" : "FAIL");
+}
@@ -23,13 +23,29 @@ void disp_show(void);
 #define LINE_HEIGHT 10
 
 /** Number of message lines */
-#define NUM_OF_LINES (OLED_HEIGHT - STATUS_BAR_HEIGHT) / LINE_HEIGHT
+#define NUM_OF_LINES ((OLED_HEIGHT - STATUS_BAR_HEIGHT) / LINE_HEIGHT)
 
-/** Line buffer for messages */
-char disp_buffer[NUM_OF_LINES + 1][32] = {0};
+/** Length of a line in the buffer */
+#define LINE_LENGTH 32
 
-/** Current line used */
-uint8_t current_line = 0;
+#if OLED_HISTORY < NUM_OF_LINES
+#error "OLED_HISTORY must be at least the number of lines on the display"
+#endif
+
+/** Ring buffer for messages, keeps OLED_HISTORY lines for scrolling back, claimed when the OLED is detected */
+char (*disp_buffer)[LINE_LENGTH] = NULL;
+
+/** Position for the next line in the ring buffer */
+uint16_t disp_head = 0;
+
+/** Number of lines in the ring buffer */
+uint16_t disp_count = 0;
+
+/** Number of lines the view is scrolled back from the newest line */
+uint16_t disp_scroll = 0;
+
+/** Last status bar text, the status bar is only redrawn if the text changed */
+static char last_header[32] = {0};
 
 /** Display class using Wire */
 SSD1306Wire oled_display(0x3c, PIN_WIRE_SDA, PIN_WIRE_SCL, GEOMETRY_128_64, &Wire);
@@ -48,7 +64,7 @@ bool init_rak1921(void)
 	delay(500); // Give display reset some time
 
 	// Some modules support only 100kHz
-	Wire.setClock(100000);
+	i2c_bus_take(I2C_ALL_DEVICES);
 	for (byte address = 1; address < 127; address++)
 	{
 		Wire.beginTransmission(address);
@@ -61,13 +77,25 @@ bool init_rak1921(void)
 			}
 		}
 	}
+	i2c_bus_give();
 
 	if (!has_rak1921)
 	{
 		return false;
 	}
 
+	if (disp_buffer == NULL)
+	{
+		disp_buffer = (char(*)[LINE_LENGTH])disp_arena_claim(OLED_HISTORY * LINE_LENGTH, "OLED lines");
+		if (disp_buffer == NULL)
+		{
+			has_rak1921 = false;
+			return false;
+		}
+	}
+
 	// taskENTER_CRITICAL();
+	i2c_bus_take(0x3c);
 	oled_display.setI2cAutoInit(true);
 	oled_display.init();
 	oled_display.displayOff();
@@ -77,6 +105,7 @@ bool init_rak1921(void)
 	oled_display.setContrast(128);
 	oled_display.setFont(ArialMT_Plain_10);
 	oled_display.display();
+	i2c_bus_give();
 	// taskEXIT_CRITICAL();
 
 	return true;
@@ -101,7 +130,9 @@ void rak1921_write_header(char *header_line)
 
 	// draw divider line
 	oled_display.drawLine(0, 11, 128, 11);
+	i2c_bus_take(0x3c);
 	oled_display.display();
+	i2c_bus_give();
 	// taskEXIT_CRITICAL();
 }
 
@@ -112,44 +143,97 @@ void rak1921_write_header(char *header_line)
  */
 void rak1921_add_line(char *line)
 {
+	if (disp_buffer == NULL)
+	{
+		return;
+	}
 	// taskENTER_CRITICAL();
-	if (current_line == NUM_OF_LINES)
+	// Overwrites the oldest line if the ring buffer is full
+	snprintf(disp_buffer[disp_head], LINE_LENGTH, "%s", line);
+	disp_head = (disp_head + 1) % OLED_HISTORY;
+	if (disp_count < OLED_HISTORY)
 	{
-		// Display is full, shift text one line up
-		for (int idx = 0; idx < NUM_OF_LINES; idx++)
-		{
-			memcpy(disp_buffer[idx], disp_buffer[idx + 1], 32);
-		}
-		current_line--;
+		disp_count++;
 	}
-	snprintf(disp_buffer[current_line], 32, "%s", line);
 
-	if (current_line != NUM_OF_LINES)
+	if (disp_scroll != 0)
 	{
-		current_line++;
+		// Keep the view on the same lines while scrolled back
+		if (disp_scroll < disp_count - NUM_OF_LINES)
+		{
+			disp_scroll++;
+			return;
+		}
+		// Oldest line of the view was overwritten
+		disp_scroll = disp_count - NUM_OF_LINES;
 	}
 
 	rak1921_show();
 	// taskEXIT_CRITICAL();
 }
 
+/**
+ * @brief Scroll the message area through the history
+ *
+ * @param lines number of lines back from the newest line, 0 shows the newest lines
+ * @return uint16_t number of lines scrolled back, limited by the history
+ */
+uint16_t rak1921_scroll(uint16_t lines)
+{
+	uint16_t max_scroll = disp_count > NUM_OF_LINES ? disp_count - NUM_OF_LINES : 0;
+	disp_scroll = lines < max_scroll ? lines : max_scroll;
+	rak1921_show();
+	return disp_scroll;
+}
+
+/**
+ * @brief Get the number of lines the view is scrolled back
+ *
+ * @return uint16_t number of lines, 0 if the newest lines are shown
+ */
+uint16_t rak1921_scroll_pos(void)
+{
+	return disp_scroll;
+}
+
+/**
+ * @brief Get the number of lines in the history
+ *
+ * @return uint16_t number of lines
+ */
+uint16_t rak1921_history(void)
+{
+	return disp_count;
+}
+
 /**
  * @brief Update display messages
  *
  */
 void rak1921_show(void)
 {
+	TRACE_SCOPE("oled_show");
+	if (disp_buffer == NULL)
+	{
+		return;
+	}
+
 	oled_display.setColor(BLACK);
 	oled_display.fillRect(0, STATUS_BAR_HEIGHT + 1, OLED_WIDTH, OLED_HEIGHT);
 
 	oled_display.setFont(ArialMT_Plain_10);
 	oled_display.setColor(WHITE);
 	oled_display.setTextAlignment(TEXT_ALIGN_LEFT);
-	for (int line = 0; line < current_line; line++)
+	// Window of NUM_OF_LINES lines, ending disp_scroll lines before the newest line
+	uint16_t visible = disp_count < NUM_OF_LINES ? disp_count : NUM_OF_LINES;
+	uint16_t first = (disp_head + OLED_HISTORY - disp_scroll - visible) % OLED_HISTORY;
+	for (int line = 0; line < visible; line++)
 	{
-		oled_display.drawString(0, (line * LINE_HEIGHT) + STATUS_BAR_HEIGHT + 1, disp_buffer[line]);
+		oled_display.drawString(0, (line * LINE_HEIGHT) + STATUS_BAR_HEIGHT + 1, disp_buffer[(first + line) % OLED_HISTORY]);
 	}
+	i2c_bus_take(0x3c);
 	oled_display.display();
+	i2c_bus_give();
 }
 
 /**
@@ -161,5 +245,59 @@ void rak1921_clear(void)
 	oled_display.setColor(BLACK);
 	oled_display.fillRect(0, STATUS_BAR_HEIGHT + 1, OLED_WIDTH, OLED_HEIGHT);
 	oled_display.setColor(WHITE);
-	current_line = 0;
+	disp_head = 0;
+	disp_count = 0;
+	disp_scroll = 0;
+}
+
+/**
+ * @brief Force a redraw of the status bar on the next result view call
+ *
+ */
+void rak1921_header_invalidate(void)
+{
+	last_header[0] = 0;
+}
+
+/**
+ * @brief Get the CRC-32 of the display framebuffer
+ *
+ * @return uint32_t CRC-32 of the framebuffer
+ */
+uint32_t rak1921_crc(void)
+{
+	return crc32_update(CRC32_INIT, oled_display.buffer, OLED_WIDTH * OLED_HEIGHT / 8);
+}
+
+/**
+ * @brief Result model view, shows a summary of the results in the status bar
+ * 		+ = OK, - = failed, ? = not tested or no module
+ *
+ * @param changed mask of the changed result fields
+ */
+void rak1921_result_view(uint32_t changed)
+{
+	char header[32];
+
+	if ((changed & (RESULT_BIT(RESULT_FLASH) | RESULT_BIT(RESULT_LORA) | RESULT_BIT(RESULT_TX) |
+					RESULT_BIT(RESULT_GNSS) | RESULT_BIT(RESULT_BATT))) == 0)
+	{
+		return;
+	}
+
+	int32_t tx = result_get(RESULT_TX);
+	int32_t gnss = result_get(RESULT_GNSS);
+	FMT(header, sizeof(header), "FL%c LR%c TX%c GN%c %.2fV",
+			 result_get(RESULT_FLASH) ? '+' : '-',
+			 result_get(RESULT_LORA) ? '+' : '-',
+			 tx == 2 ? '?' : (tx == 0 ? '+' : '-'),
+			 gnss == 2 ? '?' : (gnss == 1 ? '+' : '-'),
+			 fmt_fix(result_get(RESULT_BATT), 3));
+
+	// Only the status bar is redrawn, and only if the text changed
+	if (strcmp(header, last_header) != 0)
+	{
+		strcpy(last_header, header);
+		rak1921_write_header(header);
+	}
 }
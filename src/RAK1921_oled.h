@@ -17,10 +17,21 @@
 #define PIN_WIRE_SCL SCL
 #endif
 
+/** Number of lines kept for scrolling back, at least the lines on the display */
+#ifndef OLED_HISTORY
+#define OLED_HISTORY 32
+#endif
+
 bool init_rak1921(void);
 void rak1921_add_line(char *line);
 void rak1921_show(void);
 void rak1921_write_header(char *header_line);
 void rak1921_clear(void);
+void rak1921_result_view(uint32_t changed);
+uint16_t rak1921_scroll(uint16_t lines);
+uint16_t rak1921_scroll_pos(void);
+uint16_t rak1921_history(void);
+void rak1921_header_invalidate(void);
+uint32_t rak1921_crc(void);
 
 #endif // RAK1921_H
\ No newline at end of file
@@ -0,0 +1,212 @@
+/**
+ * @file benchmark.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Cycle counting benchmarks of the driver primitives
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Enabled with -DHW_BENCHMARK=1 (see env:wiscore_rak4631_bench in platformio.ini).
+ * Results are printed as CSV lines starting with "BENCH," so they can be
+ * filtered from the rest of the log output.
+ */
+#include "main.h"
+
+#if HW_BENCHMARK > 0
+#include <radio/radio.h>
+#include <nRF_SSD1306Wire.h>
+#include <rak14000.h>
+#include "epd_blit.h"
+
+/** Number of iterations for fast primitives */
+#ifndef BENCH_ITERATIONS
+#define BENCH_ITERATIONS 50
+#endif
+/** Number of iterations for slow primitives (EPD refresh, flash write) */
+#ifndef BENCH_ITERATIONS_SLOW
+#define BENCH_ITERATIONS_SLOW 3
+#endif
+
+extern SSD1306Wire oled_display;
+extern Paint *paint;
+extern EPD_213_BW epd;
+extern unsigned char *image;
+
+/**
+ * @brief Enable the DWT cycle counter
+ *
+ */
+static void bench_dwt_init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Run a function several times and print the cycle statistics
+ *
+ * @param name name of the benchmark
+ * @param bench_func function to measure
+ * @param iterations number of runs
+ */
+void bench_run(const char *name, void (*bench_func)(void), uint16_t iterations)
+{
+	uint32_t min_cycles = UINT32_MAX;
+	uint32_t max_cycles = 0;
+	uint64_t sum = 0;
+	uint64_t sum_sq = 0;
+
+	for (uint16_t run = 0; run < iterations; run++)
+	{
+		uint32_t start = DWT->CYCCNT;
+		bench_func();
+		uint32_t cycles = DWT->CYCCNT - start;
+
+		if (cycles < min_cycles)
+		{
+			min_cycles = cycles;
+		}
+		if (cycles > max_cycles)
+		{
+			max_cycles = cycles;
+		}
+		sum += cycles;
+		sum_sq += (uint64_t)cycles * cycles;
+	}
+
+	double mean = (double)sum / iterations;
+	double variance = ((double)sum_sq / iterations) - (mean * mean);
+	double stddev = variance > 0.0 ? sqrt(variance) : 0.0;
+
+	Serial.printf("BENCH,%s,%d,%lu,%lu,%lu,%lu\n", name, iterations,
+				  (unsigned long)min_cycles, (unsigned long)(mean + 0.5), (unsigned long)max_cycles, (unsigned long)(stddev + 0.5));
+	Serial.flush();
+}
+
+static void bench_i2c_probe(void)
+{
+	Wire.beginTransmission(0x3c);
+	Wire.endTransmission();
+}
+
+static void bench_oled_display(void)
+{
+	oled_display.display();
+}
+
+static void bench_oled_add_line(void)
+{
+	rak1921_add_line((char *)"Benchmark line");
+}
+
+static void bench_draw_string(void)
+{
+	paint->DrawStringAt(0, 4, (char *)"RAK Test Firmware", &Font20, COLORED);
+}
+
+static void bench_blit_string(void)
+{
+	epd_blit_string(0, 4, (char *)"RAK Test Firmware", &Font20);
+}
+
+static void bench_epd_compose(void)
+{
+	compose_rak14000();
+}
+
+static void bench_epd_display(void)
+{
+	epd.Display(image);
+}
+
+static void bench_read_batt(void)
+{
+	read_batt();
+}
+
+static void bench_sx126x_read(void)
+{
+	uint16_t sync_word;
+	SX126xReadRegisters(REG_LR_SYNCWORD, (uint8_t *)&sync_word, 2);
+}
+
+static void bench_save_settings(void)
+{
+	save_settings();
+}
+
+/** Inputs of the formatter benches, volatile so they are not folded at compile time */
+static volatile int32_t bench_batt_mv = 4012;
+static volatile int32_t bench_lat = -274789700;
+static volatile int32_t bench_lon = 1530234560;
+static char bench_str[32];
+
+static void bench_snprintf_batt(void)
+{
+	snprintf(bench_str, sizeof(bench_str), "Batt %.2fV", bench_batt_mv / 1000.0);
+}
+
+static void bench_fmt_batt(void)
+{
+	FMT(bench_str, sizeof(bench_str), "Batt %.2fV", fmt_fix(bench_batt_mv, 3));
+}
+
+static void bench_snprintf_latlon(void)
+{
+	snprintf(bench_str, sizeof(bench_str), "L: %.6f:%.6f", bench_lat / 10000000.0, bench_lon / 10000000.0);
+}
+
+static void bench_fmt_latlon(void)
+{
+	FMT(bench_str, sizeof(bench_str), "L: %.6f:%.6f", fmt_fix(bench_lat, 7), fmt_fix(bench_lon, 7));
+}
+
+/**
+ * @brief Run all benchmarks
+ * 		Benchmarks for modules that were not detected are skipped.
+ *
+ */
+void run_benchmarks(void)
+{
+	bench_dwt_init();
+
+	Serial.printf("BENCH,cpu_hz,%lu\n", (unsigned long)SystemCoreClock);
+	Serial.println("BENCH,name,n,min,mean,max,stddev");
+
+	bench_run("i2c_probe", bench_i2c_probe, BENCH_ITERATIONS);
+	if (has_rak1921)
+	{
+		bench_run("ssd1306_display", bench_oled_display, BENCH_ITERATIONS);
+		bench_run("rak1921_add_line", bench_oled_add_line, BENCH_ITERATIONS);
+	}
+	// Paint works on the RAM buffer only, no EPD required
+	if (rak14000_alloc())
+	{
+		paint->SetRotate(ROTATE_270);
+		epd_blit_init(paint, image, EPD_BUFFER_SIZE);
+		bench_run("paint_draw_string", bench_draw_string, BENCH_ITERATIONS);
+		bench_run("blit_draw_string", bench_blit_string, BENCH_ITERATIONS);
+		bool use_blit = epd_use_blit;
+		epd_use_blit = false;
+		bench_run("epd_compose_paint", bench_epd_compose, BENCH_ITERATIONS);
+		epd_use_blit = true;
+		bench_run("epd_compose_blit", bench_epd_compose, BENCH_ITERATIONS);
+		epd_use_blit = use_blit;
+	}
+	if (has_rak14000)
+	{
+		bench_run("epd_display", bench_epd_display, BENCH_ITERATIONS_SLOW);
+	}
+	bench_run("read_batt", bench_read_batt, BENCH_ITERATIONS);
+	bench_run("sx126x_read_registers", bench_sx126x_read, BENCH_ITERATIONS);
+	bench_run("save_settings", bench_save_settings, BENCH_ITERATIONS_SLOW);
+	bench_run("snprintf_batt", bench_snprintf_batt, BENCH_ITERATIONS);
+	bench_run("fmt_batt", bench_fmt_batt, BENCH_ITERATIONS);
+	bench_run("snprintf_latlon", bench_snprintf_latlon, BENCH_ITERATIONS);
+	bench_run("fmt_latlon", bench_fmt_latlon, BENCH_ITERATIONS);
+
+	Serial.println("BENCH,done");
+}
+#endif
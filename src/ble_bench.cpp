@@ -0,0 +1,215 @@
+/**
+ * @file ble_bench.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief BLE UART throughput test with MTU and connection parameter negotiation
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "main.h"
+#include "ble_bench.h"
+
+/** Shortest connection interval allowed, 6 * 1.25ms = 7.5ms */
+#define BLE_BENCH_CONN_INTERVAL 6
+/** Stop RX test if no data arrives for this time in ms */
+#define BLE_BENCH_RX_TIMEOUT 3000
+
+/** Receiver state, static because of the frame buffer */
+static ble_bench_rx_s bench_rx;
+
+/**
+ * @brief Ask the central for a larger MTU, data length extension and the shortest connection interval
+ *
+ * @return uint16_t usable frame size (MTU - 3)
+ */
+static uint16_t ble_bench_negotiate(void)
+{
+	BLEConnection *connection = Bluefruit.Connection(Bluefruit.connHandle());
+	if (connection == NULL)
+	{
+		return 20;
+	}
+
+	connection->requestMtuExchange(BLE_BENCH_MAX_FRAME + 3);
+	connection->requestDataLengthUpdate();
+	connection->requestConnectionParameter(BLE_BENCH_CONN_INTERVAL);
+
+	// Give the central time to accept the new parameters
+	delay(1000);
+
+	uint16_t frame_size = connection->getMtu() - 3;
+	if (frame_size > BLE_BENCH_MAX_FRAME)
+	{
+		frame_size = BLE_BENCH_MAX_FRAME;
+	}
+	MYLOG("BENCH", "MTU %d, interval %d x 1.25ms", connection->getMtu(), connection->getConnectionInterval());
+	return frame_size;
+}
+
+/**
+ * @brief Send the result line over BLE and USB
+ *
+ */
+static void ble_bench_report(const char *dir, uint32_t frames, uint32_t bytes, uint32_t time_ms,
+							 uint32_t retries, uint32_t lost, uint32_t corrupt)
+{
+	BLEConnection *connection = Bluefruit.Connection(Bluefruit.connHandle());
+	uint16_t mtu = connection != NULL ? connection->getMtu() : 0;
+	uint16_t interval = connection != NULL ? connection->getConnectionInterval() : 0;
+	char result[128];
+
+	snprintf(result, sizeof(result), "BENCH,%s,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%d,%d", dir, frames, bytes, time_ms,
+			 ble_bench_kbps(bytes, time_ms), retries, lost, corrupt, mtu, interval);
+	Serial.println(result);
+	if (g_ble_uart_is_connected)
+	{
+		g_ble_uart.println(result);
+	}
+}
+
+/**
+ * @brief Stream frames to the central
+ *
+ * @param seconds test duration
+ * @param frame_size size of each frame
+ */
+static void ble_bench_tx(uint16_t seconds, uint16_t frame_size)
+{
+	uint8_t frame[BLE_BENCH_MAX_FRAME];
+	uint16_t seq = 0;
+	uint32_t frames = 0;
+	uint32_t retries = 0;
+	// Tell the central that the pattern stream starts now
+	g_ble_uart.printf("BENCH,START,%d\n", frame_size);
+	time_t start = millis();
+
+	while (g_ble_uart_is_connected && ((millis() - start) < (uint32_t)seconds * 1000))
+	{
+		ble_bench_fill(frame, frame_size, seq);
+		uint16_t sent = 0;
+		while (sent < frame_size)
+		{
+			size_t written = g_ble_uart.write(&frame[sent], frame_size - sent);
+			if (written == 0)
+			{
+				if (!g_ble_uart_is_connected)
+				{
+					break;
+				}
+				// TX queue full, try again
+				retries++;
+				delay(1);
+			}
+			else if (written < (size_t)(frame_size - sent))
+			{
+				retries++;
+			}
+			sent += written;
+		}
+		seq++;
+		frames++;
+	}
+	g_ble_uart.flushTXD();
+
+	ble_bench_report("TX", frames, frames * frame_size, millis() - start, retries, 0, 0);
+}
+
+/**
+ * @brief Receive frames from the central and check them
+ *
+ * @param num_frames expected number of frames
+ * @param frame_size size of each frame
+ */
+static void ble_bench_rx(uint32_t num_frames, uint16_t frame_size)
+{
+	uint8_t rx_buff[BLE_BENCH_MAX_FRAME];
+	time_t start = 0;
+	time_t last_rx = millis();
+
+	ble_bench_rx_init(&bench_rx, frame_size);
+
+	// Tell the central we are ready and which frame size to use
+	g_ble_uart.printf("BENCH,READY,%d\n", frame_size);
+
+	while (g_ble_uart_is_connected && (bench_rx.frames < num_frames))
+	{
+		int rx_len = g_ble_uart.read(rx_buff, sizeof(rx_buff));
+		if (rx_len > 0)
+		{
+			if (start == 0)
+			{
+				start = millis();
+			}
+			last_rx = millis();
+			ble_bench_rx_feed(&bench_rx, rx_buff, rx_len);
+		}
+		else if ((millis() - last_rx) > BLE_BENCH_RX_TIMEOUT)
+		{
+			break;
+		}
+		else
+		{
+			// Let the BLE stack fill the FIFO
+			delay(1);
+		}
+	}
+
+	// Frames that never arrived at the end of the stream
+	uint32_t missing = num_frames > (bench_rx.frames + bench_rx.lost) ? num_frames - bench_rx.frames - bench_rx.lost : 0;
+	ble_bench_report("RX", bench_rx.frames, bench_rx.bytes, start != 0 ? last_rx - start : 0, 0,
+					 bench_rx.lost + missing, bench_rx.corrupt);
+}
+
+/**
+ * @brief Check if a command received over BLE is a benchmark command and execute it
+ *
+ * @param cmd received command line
+ * @return true if it was a benchmark command
+ * @return false if it was not a benchmark command
+ */
+bool ble_bench_command(char *cmd)
+{
+	if (strncmp(cmd, "BENCH=", 6) != 0)
+	{
+		return false;
+	}
+
+	char dir[3] = {0};
+	unsigned long value = 0;
+	unsigned int frame_size = 0;
+	int num_params = sscanf(&cmd[6], "%2[A-Z],%lu,%u", dir, &value, &frame_size);
+	if ((num_params < 2) || (value == 0))
+	{
+		g_ble_uart.println("BENCH,ERROR");
+		return true;
+	}
+
+	uint16_t max_frame = ble_bench_negotiate();
+	if ((frame_size < BLE_BENCH_MIN_FRAME) || (frame_size > max_frame))
+	{
+		frame_size = max_frame;
+	}
+
+	if ((strcmp(dir, "TX") == 0) && (value > UINT16_MAX))
+	{
+		// Duration is kept as uint16_t seconds
+		g_ble_uart.println("BENCH,ERROR");
+	}
+	else if (strcmp(dir, "TX") == 0)
+	{
+		MYLOG("BENCH", "TX %ld s, frame size %d", value, frame_size);
+		ble_bench_tx(value, frame_size);
+	}
+	else if (strcmp(dir, "RX") == 0)
+	{
+		MYLOG("BENCH", "RX %ld frames, frame size %d", value, frame_size);
+		ble_bench_rx(value, frame_size);
+	}
+	else
+	{
+		g_ble_uart.println("BENCH,ERROR");
+	}
+	return true;
+}
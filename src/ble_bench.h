@@ -0,0 +1,149 @@
+/**
+ * @file ble_bench.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief BLE UART throughput test, frame protocol
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The protocol part has no dependency on Arduino or Bluefruit, it is tested
+ * on the host over a loopback stand-in for the BLE link (test/host).
+ *
+ * Frame layout:
+ * | seq LSB | seq MSB | pattern byte 2 ... pattern byte n-1 |
+ * Pattern byte i of a frame is (seq + i) & 0xFF
+ *
+ * Commands (sent as a line over BLE UART):
+ * BENCH=TX,<seconds>[,<frame size>]  device streams frames to the host, 1 to 65535 s
+ * BENCH=RX,<frames>[,<frame size>]   host streams frames to the device
+ *
+ * Result line (sent over BLE UART and USB):
+ * BENCH,<TX|RX>,<frames>,<bytes>,<ms>,<kbit/s>,<retries>,<lost>,<corrupt>,<mtu>,<conn interval units>
+ */
+#ifndef BLE_BENCH_H
+#define BLE_BENCH_H
+#include <stdint.h>
+#include <string.h>
+
+/** Max frame size, ATT MTU 247 - 3 bytes ATT header */
+#define BLE_BENCH_MAX_FRAME 244
+/** Min frame size, sequence number + 1 pattern byte */
+#define BLE_BENCH_MIN_FRAME 3
+
+/** Receiver state */
+struct ble_bench_rx_s
+{
+	uint16_t frame_size;
+	uint16_t fill;
+	uint16_t next_seq;
+	uint32_t frames;
+	uint32_t bytes;
+	uint32_t lost;
+	uint32_t corrupt;
+	uint8_t frame[BLE_BENCH_MAX_FRAME];
+};
+
+/**
+ * @brief Fill a frame with the sequence number and the test pattern
+ *
+ * @param frame buffer for the frame
+ * @param frame_size size of the frame
+ * @param seq sequence number
+ */
+inline void ble_bench_fill(uint8_t *frame, uint16_t frame_size, uint16_t seq)
+{
+	frame[0] = (uint8_t)(seq);
+	frame[1] = (uint8_t)(seq >> 8);
+	for (uint16_t idx = 2; idx < frame_size; idx++)
+	{
+		frame[idx] = (uint8_t)(seq + idx);
+	}
+}
+
+/**
+ * @brief Reset the receiver
+ *
+ * @param rx receiver state
+ * @param frame_size expected frame size
+ */
+inline void ble_bench_rx_init(ble_bench_rx_s *rx, uint16_t frame_size)
+{
+	memset(rx, 0, sizeof(ble_bench_rx_s));
+	rx->frame_size = frame_size;
+}
+
+/**
+ * @brief Check a complete frame, count lost and corrupted frames
+ *
+ * @param rx receiver state
+ */
+inline void ble_bench_rx_check(ble_bench_rx_s *rx)
+{
+	uint16_t seq = rx->frame[0] | (rx->frame[1] << 8);
+	if (seq != rx->next_seq)
+	{
+		rx->lost += (uint16_t)(seq - rx->next_seq);
+	}
+	for (uint16_t idx = 2; idx < rx->frame_size; idx++)
+	{
+		if (rx->frame[idx] != (uint8_t)(seq + idx))
+		{
+			rx->corrupt++;
+			break;
+		}
+	}
+	rx->next_seq = seq + 1;
+	rx->frames++;
+	rx->bytes += rx->frame_size;
+}
+
+/**
+ * @brief Feed received bytes into the receiver
+ * 		The BLE UART is a byte stream, frames can be split or merged.
+ *
+ * @param rx receiver state
+ * @param data received data
+ * @param len number of received bytes
+ */
+inline void ble_bench_rx_feed(ble_bench_rx_s *rx, const uint8_t *data, uint16_t len)
+{
+	while (len != 0)
+	{
+		uint16_t copy_len = rx->frame_size - rx->fill;
+		if (copy_len > len)
+		{
+			copy_len = len;
+		}
+		memcpy(&rx->frame[rx->fill], data, copy_len);
+		rx->fill += copy_len;
+		data += copy_len;
+		len -= copy_len;
+		if (rx->fill == rx->frame_size)
+		{
+			ble_bench_rx_check(rx);
+			rx->fill = 0;
+		}
+	}
+}
+
+/**
+ * @brief Throughput in kbit/s
+ *
+ * @param bytes transferred bytes
+ * @param time_ms duration in ms
+ * @return uint32_t kbit/s
+ */
+inline uint32_t ble_bench_kbps(uint32_t bytes, uint32_t time_ms)
+{
+	if (time_ms == 0)
+	{
+		return 0;
+	}
+	return (uint32_t)(((uint64_t)bytes * 8) / time_ms);
+}
+
+// Firmware functions
+bool ble_bench_command(char *cmd);
+
+#endif // BLE_BENCH_H
@@ -0,0 +1,217 @@
+/**
+ * @file boot_log.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Fast boot, early log output is kept in RAM until USB or BLE is connected
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Without a host on USB the output of MYLOG is lost, so init_app() used to
+ * wait up to 5 seconds for USB before the first test.
+ * With FAST_BOOT the tests start at once and MYLOG writes into a RAM buffer.
+ * A low priority task replays the buffer when USB CDC is opened by the host
+ * or a BLE UART client connects. New lines are appended to the buffer while
+ * the replay runs, so the order is kept. After the USB replay MYLOG writes
+ * directly again and the buffer is freed.
+ */
+#include "main.h"
+
+/** Interval in ms to check for USB and BLE */
+#define BOOT_LOG_POLL 50
+
+/** Early log buffer, NULL after the USB replay */
+static char *boot_log_buf = NULL;
+/** Bytes in the buffer */
+static volatile uint16_t boot_log_len = 0;
+/** Bytes that did not fit */
+static volatile uint32_t boot_log_dropped = 0;
+/** Bytes already sent to USB and BLE */
+static uint16_t boot_log_usb_pos = 0;
+static uint16_t boot_log_ble_pos = 0;
+/** Flag if MYLOG writes into the buffer */
+static volatile bool boot_log_on = false;
+/** Flag if the BLE replay is finished and new lines go directly to BLE */
+static volatile bool boot_log_ble_live = false;
+
+/** Time from reset to the first test in ms */
+uint32_t boot_first_test_ms = 0;
+
+/**
+ * @brief Send the part of the buffer a sink did not get yet
+ * 		Finished when the sink has everything, checked inside a critical section
+ * 		so no line is appended between the last write and the switch to direct output.
+ *
+ * @param stream USB or BLE
+ * @param pos bytes already sent
+ * @param usb true for USB, the buffering stops after the USB replay
+ */
+static void boot_log_replay(Stream &stream, uint16_t *pos, bool usb)
+{
+	while (true)
+	{
+		taskENTER_CRITICAL();
+		uint16_t len = boot_log_len;
+		if (*pos == len)
+		{
+			if (usb)
+			{
+				boot_log_on = false;
+			}
+			else
+			{
+				boot_log_ble_live = true;
+			}
+			taskEXIT_CRITICAL();
+			return;
+		}
+		taskEXIT_CRITICAL();
+		stream.write((uint8_t *)&boot_log_buf[*pos], len - *pos);
+		*pos = len;
+	}
+}
+
+/**
+ * @brief Task that replays the buffer to USB and BLE
+ * 		Ends after the USB replay
+ *
+ * @param pvParameters unused
+ */
+static void boot_log_task(void *pvParameters)
+{
+	bool usb_done = false;
+	while (!usb_done)
+	{
+		if (g_ble_uart_is_connected && !boot_log_ble_live)
+		{
+			boot_log_replay(g_ble_uart, &boot_log_ble_pos, false);
+		}
+		if (Serial)
+		{
+			// MYLOG writes to USB and BLE directly after this
+			boot_log_replay(Serial, &boot_log_usb_pos, true);
+			usb_done = true;
+		}
+		else
+		{
+			delay(BOOT_LOG_POLL);
+		}
+	}
+
+	if (boot_log_dropped != 0)
+	{
+		MYLOG("BOOT", "%ld bytes of the early log were dropped", boot_log_dropped);
+	}
+	MYLOG("BOOT", "Reset to first test %ld ms", boot_first_test_ms);
+	free(boot_log_buf);
+	boot_log_buf = NULL;
+	vTaskDelete(NULL);
+}
+
+/**
+ * @brief Start buffering the log output
+ *
+ */
+void boot_log_init(void)
+{
+#if FAST_BOOT > 0
+	if (boot_log_buf != NULL)
+	{
+		return;
+	}
+	boot_log_buf = (char *)malloc(BOOT_LOG_SIZE);
+	if (boot_log_buf == NULL)
+	{
+		return;
+	}
+	boot_log_on = true;
+	if (xTaskCreate(boot_log_task, "BLOG", 512, NULL, TASK_PRIO_LOWEST, NULL) != pdPASS)
+	{
+		boot_log_on = false;
+		free(boot_log_buf);
+		boot_log_buf = NULL;
+	}
+#endif
+}
+
+/**
+ * @brief Check if MYLOG writes into the buffer
+ *
+ * @return true if the output is buffered
+ */
+bool boot_log_active(void)
+{
+	return boot_log_on;
+}
+
+/**
+ * @brief Write a log line into the buffer
+ * 		Sent to BLE directly if the BLE replay is finished
+ *
+ * @param tag Tag of the message or NULL
+ * @param fmt printf style format string
+ */
+void boot_log_printf(const char *tag, const char *fmt, ...)
+{
+	char line[BOOT_LOG_LINE];
+	int len = 0;
+	if (tag != NULL)
+	{
+		len = snprintf(line, sizeof(line), "[%s] ", tag);
+	}
+	va_list args;
+	va_start(args, fmt);
+	len += vsnprintf(&line[len], sizeof(line) - len, fmt, args);
+	va_end(args);
+	if (len > (int)sizeof(line) - 2)
+	{
+		len = sizeof(line) - 2;
+	}
+	line[len++] = '\n';
+	line[len] = 0;
+
+	bool direct = false;
+	taskENTER_CRITICAL();
+	// Read once, a line buffered while BLE was not live yet is sent by the replay only
+	bool ble_live = boot_log_ble_live;
+	if (!boot_log_on)
+	{
+		// USB replay finished in between
+		taskEXIT_CRITICAL();
+		Serial.write((uint8_t *)line, len);
+		direct = true;
+	}
+	else if (boot_log_len + len <= BOOT_LOG_SIZE)
+	{
+		memcpy(&boot_log_buf[boot_log_len], line, len);
+		boot_log_len += len;
+		if (ble_live)
+		{
+			boot_log_ble_pos = boot_log_len;
+		}
+		taskEXIT_CRITICAL();
+	}
+	else
+	{
+		boot_log_dropped += len;
+		taskEXIT_CRITICAL();
+	}
+
+	if ((direct || ble_live) && g_ble_uart_is_connected)
+	{
+		g_ble_uart.write((uint8_t *)line, len);
+	}
+}
+
+/**
+ * @brief Create a compact line with the fast boot status
+ * 		Format: FAST_BOOT=<0|1>,FIRST_TEST=<ms after reset>,BUFFERED=<bytes>,DROPPED=<bytes>
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void boot_log_report(char *buff, size_t buff_size)
+{
+	snprintf(buff, buff_size, "FAST_BOOT=%d,FIRST_TEST=%ld,BUFFERED=%d,DROPPED=%ld", FAST_BOOT,
+			 boot_first_test_ms, boot_log_len, boot_log_dropped);
+}
@@ -0,0 +1,35 @@
+/**
+ * @file boot_log.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Fast boot, early log output is kept in RAM until USB or BLE is connected
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef BOOT_LOG_H
+#define BOOT_LOG_H
+#include <Arduino.h>
+
+/** Fast boot, start the tests without waiting for USB. Set to 0 to wait up to 5 seconds for USB */
+#ifndef FAST_BOOT
+#define FAST_BOOT 1
+#endif
+
+/** Size of the early log buffer, lines that do not fit are dropped */
+#ifndef BOOT_LOG_SIZE
+#define BOOT_LOG_SIZE 4096
+#endif
+
+/** Max length of one log line */
+#define BOOT_LOG_LINE 128
+
+void boot_log_init(void);
+bool boot_log_active(void);
+void boot_log_printf(const char *tag, const char *fmt, ...);
+void boot_log_report(char *buff, size_t buff_size);
+/** Time from reset to the first test in ms */
+extern uint32_t boot_first_test_ms;
+
+#endif // BOOT_LOG_H
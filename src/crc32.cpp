@@ -0,0 +1,36 @@
+/**
+ * @file crc32.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief CRC-32 (IEEE 802.3, same as zlib.crc32) for data exported to the host
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Nibble table version, 64 bytes of flash instead of 1 kB for the byte table.
+ */
+#include "main.h"
+
+static const uint32_t crc32_nibble[16] = {
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+
+/**
+ * @brief Add data to a CRC-32
+ *
+ * @param crc CRC32_INIT or the result of the last call
+ * @param data data
+ * @param len number of bytes
+ * @return uint32_t CRC-32 of all data so far
+ */
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+	crc = ~crc;
+	for (size_t idx = 0; idx < len; idx++)
+	{
+		crc ^= data[idx];
+		crc = (crc >> 4) ^ crc32_nibble[crc & 0x0f];
+		crc = (crc >> 4) ^ crc32_nibble[crc & 0x0f];
+	}
+	return ~crc;
+}
@@ -0,0 +1,20 @@
+/**
+ * @file crc32.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief CRC-32 (IEEE 802.3, same as zlib.crc32) for data exported to the host
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef CRC32_H
+#define CRC32_H
+#include <Arduino.h>
+
+/** Start value, pass the result of the last call to continue */
+#define CRC32_INIT 0
+
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len);
+
+#endif // CRC32_H
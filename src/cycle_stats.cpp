@@ -0,0 +1,156 @@
+/**
+ * @file cycle_stats.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Wake-up jitter and handler run time histograms of the test cycle
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The STATUS timer should wake the loop every send_repeat_time ms.
+ * The intended wake time of cycle n is the first wake time plus
+ * n x send_repeat_time, so a single late cycle is counted once and a slow
+ * drift of the timer shows up as growing jitter. The schedule starts again
+ * when send_repeat_time changes.
+ * A cycle that starts late because the loop was blocked (GNSS poll,
+ * EPD refresh, BLE commands) shows up in the jitter histogram, a long
+ * STATUS handler in the run time histogram.
+ */
+#include "main.h"
+
+static const uint32_t cycle_jitter_limits[CYCLE_BUCKETS - 1] = CYCLE_JITTER_LIMITS;
+static const uint32_t cycle_run_limits[CYCLE_BUCKETS - 1] = CYCLE_RUN_LIMITS;
+
+/** Histograms */
+static uint16_t cycle_jitter_hist[CYCLE_BUCKETS];
+static uint16_t cycle_run_hist[CYCLE_BUCKETS];
+
+/** Number of measured cycles */
+static uint32_t cycle_count = 0;
+/** Flag if the schedule has a start */
+static bool cycle_anchored = false;
+/** Time of the first wake-up of the schedule */
+static uint32_t cycle_anchor_us = 0;
+/** Period of the schedule in ms */
+static uint32_t cycle_period_ms = 0;
+/** Number of periods since the first wake-up */
+static uint32_t cycle_periods = 0;
+/** Extremes, jitter is signed, negative is early */
+static int32_t cycle_jitter_min = 0;
+static int32_t cycle_jitter_max = 0;
+static uint32_t cycle_run_max = 0;
+
+/**
+ * @brief Count a value in a histogram
+ *
+ * @param hist histogram
+ * @param limits upper bucket limits
+ * @param value_ms value in ms
+ */
+static void cycle_count_value(uint16_t *hist, const uint32_t *limits, uint32_t value_ms)
+{
+	uint8_t bucket = 0;
+	while ((bucket < CYCLE_BUCKETS - 1) && (value_ms >= limits[bucket]))
+	{
+		bucket++;
+	}
+	// Saturate instead of wrapping to 0 on long soak runs
+	if (hist[bucket] != 0xffff)
+	{
+		hist[bucket]++;
+	}
+}
+
+/**
+ * @brief Record the wake-up of a test cycle
+ *
+ * @param wake_us time the STATUS event was raised
+ */
+void cycle_wake(uint32_t wake_us)
+{
+	if (g_lorawan_settings.send_repeat_time == 0)
+	{
+		cycle_anchored = false;
+		return;
+	}
+	if (!cycle_anchored || (cycle_period_ms != g_lorawan_settings.send_repeat_time))
+	{
+		// First wake-up or new period, start the schedule here
+		cycle_anchored = true;
+		cycle_anchor_us = wake_us;
+		cycle_period_ms = g_lorawan_settings.send_repeat_time;
+		cycle_periods = 0;
+		return;
+	}
+
+	// The intended time wraps with micros(), the difference stays right as long as the jitter is below 35 minutes
+	cycle_periods++;
+	uint32_t intended_us = cycle_anchor_us + cycle_periods * cycle_period_ms * 1000;
+	int32_t jitter = (int32_t)(wake_us - intended_us);
+	if ((cycle_count == 0) || (jitter < cycle_jitter_min))
+	{
+		cycle_jitter_min = jitter;
+	}
+	if ((cycle_count == 0) || (jitter > cycle_jitter_max))
+	{
+		cycle_jitter_max = jitter;
+	}
+	cycle_count++;
+	cycle_count_value(cycle_jitter_hist, cycle_jitter_limits, (jitter < 0 ? -jitter : jitter) / 1000);
+}
+
+/**
+ * @brief Record the run time of the STATUS handler
+ *
+ * @param start_us time the handler started
+ */
+void cycle_done(uint32_t start_us)
+{
+	uint32_t run = micros() - start_us;
+	if (run > cycle_run_max)
+	{
+		cycle_run_max = run;
+	}
+	cycle_count_value(cycle_run_hist, cycle_run_limits, run / 1000);
+}
+
+/**
+ * @brief Clear the histograms, the next wake-up starts a new schedule
+ *
+ */
+void cycle_reset(void)
+{
+	memset(cycle_jitter_hist, 0, sizeof(cycle_jitter_hist));
+	memset(cycle_run_hist, 0, sizeof(cycle_run_hist));
+	cycle_count = 0;
+	cycle_anchored = false;
+	cycle_jitter_min = 0;
+	cycle_jitter_max = 0;
+	cycle_run_max = 0;
+}
+
+/**
+ * @brief Create a compact line with the histograms
+ * 		Format: N=<cycles>,PERIOD=<ms>,JMIN=<us>,JMAX=<us>,RMAX=<us>;JIT=<count>,...;RUN=<count>,...
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void cycle_report(char *buff, size_t buff_size)
+{
+	int len = snprintf(buff, buff_size, "N=%ld,PERIOD=%ld,JMIN=%ld,JMAX=%ld,RMAX=%ld", cycle_count,
+					   g_lorawan_settings.send_repeat_time, cycle_jitter_min, cycle_jitter_max, cycle_run_max);
+	for (uint8_t hist = 0; hist < 2; hist++)
+	{
+		uint16_t *counts = hist == 0 ? cycle_jitter_hist : cycle_run_hist;
+		for (uint8_t bucket = 0; bucket < CYCLE_BUCKETS; bucket++)
+		{
+			if ((len < 0) || ((size_t)len >= buff_size))
+			{
+				return;
+			}
+			const char *sep = bucket != 0 ? "," : (hist == 0 ? ";JIT=" : ";RUN=");
+			len += snprintf(&buff[len], buff_size - len, "%s%d", sep, counts[bucket]);
+		}
+	}
+}
@@ -0,0 +1,28 @@
+/**
+ * @file cycle_stats.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Wake-up jitter and handler run time histograms of the test cycle
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef CYCLE_STATS_H
+#define CYCLE_STATS_H
+#include <Arduino.h>
+
+/** Number of histogram buckets, the last bucket counts all larger values */
+#define CYCLE_BUCKETS 10
+
+/** Upper bucket limits of the wake-up jitter in ms (absolute value) */
+#define CYCLE_JITTER_LIMITS {1, 2, 5, 10, 20, 50, 100, 200, 500}
+/** Upper bucket limits of the handler run time in ms */
+#define CYCLE_RUN_LIMITS {50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000}
+
+void cycle_wake(uint32_t wake_us);
+void cycle_done(uint32_t start_us);
+void cycle_reset(void);
+void cycle_report(char *buff, size_t buff_size);
+
+#endif // CYCLE_STATS_H
@@ -0,0 +1,70 @@
+/**
+ * @file disp_arena.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Display memory, claimed only when a panel is detected
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Display buffers (EPD image and Paint object, OLED lines) live as long as the
+ * firmware runs. They are taken from the heap when the panel is detected and
+ * never released, so the heap does not fragment. Without a panel no RAM is used.
+ */
+#include "main.h"
+
+/** Buffers claimed */
+static disp_claim_s disp_claims[DISP_ARENA_MAX_CLAIMS];
+static uint8_t disp_num_claims = 0;
+
+/** Total size of the arena */
+static size_t disp_arena_total = 0;
+
+/**
+ * @brief Claim a zeroed buffer for a display
+ *
+ * @param size size in bytes
+ * @param owner name of the buffer for the RAM report
+ * @return void* buffer or NULL if no memory
+ */
+void *disp_arena_claim(size_t size, const char *owner)
+{
+	if (disp_num_claims == DISP_ARENA_MAX_CLAIMS)
+	{
+		MYLOG("ARENA", "No claim left for %s", owner);
+		return NULL;
+	}
+	void *buffer = calloc(1, size);
+	if (buffer == NULL)
+	{
+		MYLOG("ARENA", "No memory for %s (%d bytes)", owner, size);
+		return NULL;
+	}
+	disp_claims[disp_num_claims].owner = owner;
+	disp_claims[disp_num_claims].size = size;
+	disp_num_claims++;
+	disp_arena_total += size;
+	return buffer;
+}
+
+/**
+ * @brief Get the total size of all claimed buffers
+ *
+ * @return size_t size in bytes
+ */
+size_t disp_arena_size(void)
+{
+	return disp_arena_total;
+}
+
+/**
+ * @brief Get the list of claimed buffers
+ *
+ * @param claims pointer to the list
+ * @return uint8_t number of buffers
+ */
+uint8_t disp_arena_claims(const disp_claim_s **claims)
+{
+	*claims = disp_claims;
+	return disp_num_claims;
+}
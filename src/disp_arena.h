@@ -0,0 +1,29 @@
+/**
+ * @file disp_arena.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Display memory, claimed only when a panel is detected
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef DISP_ARENA_H
+#define DISP_ARENA_H
+#include <Arduino.h>
+
+/** Max number of buffers in the arena */
+#define DISP_ARENA_MAX_CLAIMS 8
+
+/** Buffer claimed from the arena */
+struct disp_claim_s
+{
+	const char *owner;
+	size_t size;
+};
+
+void *disp_arena_claim(size_t size, const char *owner);
+size_t disp_arena_size(void);
+uint8_t disp_arena_claims(const disp_claim_s **claims);
+
+#endif // DISP_ARENA_H
@@ -0,0 +1,260 @@
+/**
+ * @file epd_blit.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Fast text output into the RAK14000 Paint buffer
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Paint::DrawStringAt() sets every glyph pixel with DrawPixel(), which does
+ * the rotation transform, the bounds check and a division per pixel.
+ * With ROTATE_90 or ROTATE_270 one glyph column is a run of bits inside one
+ * row of the image buffer. The fonts are transposed once into 32 bit column
+ * masks, then each glyph column is written with a shift and up to 4 byte ORs.
+ *
+ * The font tables are in the RAK14000 library and not constexpr, so the
+ * transposition is done on the first use of a font instead of at compile time.
+ * The pixel layout of the buffer is measured with Paint::DrawPixel() in
+ * epd_blit_init(), if it does not match, DrawStringAt() is used.
+ */
+#include "main.h"
+#include "epd_blit.h"
+
+/** Transposed font */
+struct epd_font_s
+{
+	sFONT *font;
+	uint32_t *columns; // EPD_BLIT_NUM_CHARS * Width masks, pixel of glyph row 0 in bit 31
+};
+
+/** Transposed fonts */
+static epd_font_s epd_fonts[EPD_BLIT_FONTS];
+
+/** Paint object and its buffer */
+static Paint *blit_paint = NULL;
+static unsigned char *blit_image = NULL;
+static size_t blit_size = 0;
+
+/** Flag if the buffer layout allows the blitter */
+static bool blit_ok = false;
+/** Bit index of logical pixel 0,0 */
+static int32_t blit_origin;
+/** Bits per logical x step, +- one row */
+static int32_t blit_dx;
+/** Bits per logical y step, +1 or -1 */
+static int32_t blit_dy;
+/** Position of logical pixel 1,1 inside its row */
+static int32_t blit_in_row;
+/** Flag if a colored pixel sets the bit, otherwise it clears it */
+static bool blit_set;
+
+/**
+ * @brief Draw one pixel with Paint and find the bit that changed
+ * 		The buffer is restored afterwards
+ *
+ * @param x logical x
+ * @param y logical y
+ * @param background byte value of the cleared buffer
+ * @return int32_t bit index (MSB first) or -1 if no bit changed
+ */
+static int32_t epd_blit_probe(int x, int y, uint8_t background)
+{
+	blit_paint->DrawPixel(x, y, COLORED);
+	for (size_t idx = 0; idx < blit_size; idx++)
+	{
+		uint8_t diff = blit_image[idx] ^ background;
+		if (diff == 0)
+		{
+			continue;
+		}
+		int32_t bit = -1;
+		for (uint8_t pos = 0; pos < 8; pos++)
+		{
+			if (diff & (0x80 >> pos))
+			{
+				bit = idx * 8 + pos;
+				blit_set = (blit_image[idx] & (0x80 >> pos)) != 0;
+				break;
+			}
+		}
+		blit_image[idx] = background;
+		// More than one bit changed, not a simple pixel
+		return (diff & (diff - 1)) == 0 ? bit : -1;
+	}
+	return -1;
+}
+
+/**
+ * @brief Measure the pixel layout of the Paint buffer
+ * 		Must be called after the rotation is set, clears the buffer
+ *
+ * @param paint Paint object
+ * @param image buffer of the Paint object
+ * @param image_size size of the buffer
+ * @return true if the blitter can be used
+ * @return false if the text is drawn with Paint
+ */
+bool epd_blit_init(Paint *paint, unsigned char *image, size_t image_size)
+{
+	if ((blit_paint == paint) && (blit_image == image))
+	{
+		return blit_ok;
+	}
+	blit_paint = paint;
+	blit_image = image;
+	blit_size = image_size;
+	blit_ok = false;
+
+	paint->Clear(UNCOLORED);
+	uint8_t background = image[0];
+
+	// Pixel 0,0 can be clipped by the rotation, probe around 1,1
+	int32_t p11 = epd_blit_probe(1, 1, background);
+	int32_t p21 = epd_blit_probe(2, 1, background);
+	int32_t p12 = epd_blit_probe(1, 2, background);
+	int32_t p19 = epd_blit_probe(1, 9, background);
+	if ((p11 < 0) || (p21 < 0) || (p12 < 0) || (p19 < 0))
+	{
+		MYLOG("EPD", "Blitter disabled, probe failed");
+		return false;
+	}
+	blit_dx = p21 - p11;
+	blit_dy = p12 - p11;
+	// y must run along the bits of a row, x from row to row
+	if (((blit_dy != 1) && (blit_dy != -1)) || (p19 - p11 != 8 * blit_dy) || (blit_dx % 8 != 0) || (abs(blit_dx) < 32))
+	{
+		MYLOG("EPD", "Blitter disabled, rotation not supported");
+		return false;
+	}
+	blit_origin = p11 - blit_dx - blit_dy;
+	blit_in_row = p11 % abs(blit_dx);
+	blit_ok = true;
+
+	// Fonts are transposed for this layout
+	for (uint8_t idx = 0; idx < EPD_BLIT_FONTS; idx++)
+	{
+		free(epd_fonts[idx].columns);
+		epd_fonts[idx].columns = NULL;
+		epd_fonts[idx].font = NULL;
+	}
+	return true;
+}
+
+/**
+ * @brief Get the transposed copy of a font, create it on first use
+ *
+ * @param font font
+ * @return uint32_t* column masks or NULL if no memory
+ */
+static uint32_t *epd_blit_font(sFONT *font)
+{
+	epd_font_s *slot = NULL;
+	for (uint8_t idx = 0; idx < EPD_BLIT_FONTS; idx++)
+	{
+		if (epd_fonts[idx].font == font)
+		{
+			return epd_fonts[idx].columns;
+		}
+		if ((slot == NULL) && (epd_fonts[idx].font == NULL))
+		{
+			slot = &epd_fonts[idx];
+		}
+	}
+	if ((slot == NULL) || (font->Height > 32))
+	{
+		return NULL;
+	}
+
+	uint32_t *columns = (uint32_t *)calloc(EPD_BLIT_NUM_CHARS * font->Width, sizeof(uint32_t));
+	if (columns == NULL)
+	{
+		return NULL;
+	}
+	uint16_t row_bytes = (font->Width + 7) / 8;
+	for (uint16_t glyph = 0; glyph < EPD_BLIT_NUM_CHARS; glyph++)
+	{
+		const uint8_t *rows = &font->table[glyph * font->Height * row_bytes];
+		uint32_t *glyph_columns = &columns[glyph * font->Width];
+		for (uint16_t row = 0; row < font->Height; row++)
+		{
+			// Bits of a row run in y direction, reversed if y counts down
+			uint32_t bit = 0x80000000 >> (blit_dy > 0 ? row : font->Height - 1 - row);
+			for (uint16_t col = 0; col < font->Width; col++)
+			{
+				if (pgm_read_byte(&rows[row * row_bytes + col / 8]) & (0x80 >> (col % 8)))
+				{
+					glyph_columns[col] |= bit;
+				}
+			}
+		}
+	}
+	slot->font = font;
+	slot->columns = columns;
+	return columns;
+}
+
+/**
+ * @brief Draw a text in COLORED, same result as Paint::DrawStringAt()
+ *
+ * @param x logical x position
+ * @param y logical y position
+ * @param text text to write
+ * @param font font to use
+ */
+void epd_blit_string(int x, int y, char *text, sFONT *font)
+{
+	uint32_t *columns = blit_ok ? epd_blit_font(font) : NULL;
+	int32_t row_bits = abs(blit_dx);
+	// Position of the first and last glyph row inside the image row
+	int32_t first_row = blit_in_row + (y - 1) * blit_dy;
+	int32_t last_row = first_row + (font->Height - 1) * blit_dy;
+	// Lowest bit of the glyph column run
+	int32_t start = blit_origin + (x * blit_dx) + (y * blit_dy) + (blit_dy < 0 ? (font->Height - 1) * blit_dy : 0);
+
+	// Text must not leave the image row or the logical height, Paint clips these pixels
+	if ((columns == NULL) || (y < 0) || (y + font->Height > blit_paint->GetWidth()) ||
+		(min(first_row, last_row) < 0) || (max(first_row, last_row) >= row_bits))
+	{
+		blit_paint->DrawStringAt(x, y, text, font, COLORED);
+		return;
+	}
+
+	int32_t max_bit = blit_size * 8;
+	int logical_width = blit_paint->GetHeight();
+	for (; *text != 0; text++, x += font->Width, start += font->Width * blit_dx)
+	{
+		uint8_t glyph = *text - EPD_BLIT_FIRST_CHAR;
+		if (glyph >= EPD_BLIT_NUM_CHARS)
+		{
+			blit_paint->DrawCharAt(x, y, *text, font, COLORED);
+			continue;
+		}
+		uint32_t *glyph_columns = &columns[glyph * font->Width];
+		int32_t col_start = start;
+		for (uint16_t col = 0; col < font->Width; col++, col_start += blit_dx)
+		{
+			if ((x + col < 0) || (x + col >= logical_width) || (col_start < 0) || (col_start >= max_bit))
+			{
+				continue;
+			}
+			uint32_t mask = glyph_columns[col] >> (col_start & 7);
+			unsigned char *dest = &blit_image[col_start >> 3];
+			for (uint8_t byte = 0; (byte < 4) && (mask != 0); byte++, mask <<= 8)
+			{
+				uint8_t bits = mask >> 24;
+				if (bits != 0)
+				{
+					if (blit_set)
+					{
+						dest[byte] |= bits;
+					}
+					else
+					{
+						dest[byte] &= ~bits;
+					}
+				}
+			}
+		}
+	}
+}
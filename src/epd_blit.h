@@ -0,0 +1,26 @@
+/**
+ * @file epd_blit.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Fast text output into the RAK14000 Paint buffer
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef EPD_BLIT_H
+#define EPD_BLIT_H
+#include <Arduino.h>
+#include <rak14000.h>
+
+/** Max number of fonts with a transposed copy */
+#define EPD_BLIT_FONTS 2
+/** First character in the font tables */
+#define EPD_BLIT_FIRST_CHAR ' '
+/** Number of characters in the font tables */
+#define EPD_BLIT_NUM_CHARS 95
+
+bool epd_blit_init(Paint *paint, unsigned char *image, size_t image_size);
+void epd_blit_string(int x, int y, char *text, sFONT *font);
+
+#endif // EPD_BLIT_H
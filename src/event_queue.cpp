@@ -0,0 +1,221 @@
+/**
+ * @file event_queue.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Lock-free queue of timestamped application events
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The WisBlock API signals events by setting bits in g_task_event_type.
+ * evq_collect() takes the application bits out of g_task_event_type with one
+ * atomic fetch-and (LDREXH/STREXH), so a bit set by an ISR or another task
+ * between read and clear is not lost. Each bit becomes a queue entry with
+ * a timestamp, entries are not merged once they are queued.
+ *
+ * The queue is a bounded ring with a sequence number per slot. There is one
+ * producer (the loop task in evq_collect()), any task can consume with
+ * evq_pop(), a consumer claims an entry with compare-and-swap on the tail.
+ *
+ * The API sets the bits in its own callbacks, the raise time is the time the
+ * loop task sees the bit first. The latency is the time an event waits in the
+ * queue behind other handlers (e.g. LORA_TX_FIN behind a STATUS cycle).
+ */
+#include "main.h"
+
+/** Queue slot */
+struct evq_slot_s
+{
+	volatile uint32_t seq;
+	app_event_s event;
+};
+
+/** The queue */
+static evq_slot_s evq_slots[EVQ_SIZE];
+/** Next position to write, only changed by the producer */
+static volatile uint32_t evq_head = 0;
+/** Next position to read */
+static volatile uint32_t evq_tail = 0;
+/** Flag if the slot sequence numbers are set */
+static bool evq_ready = false;
+
+/** Highest number of queued events */
+static uint32_t evq_max_depth = 0;
+/** Events dropped because the queue was full */
+static uint32_t evq_dropped = 0;
+
+/** Event types handled by the application, in handling order */
+static evq_stat_s evq_stats[EVQ_NUM_TYPES] = {
+	{STATUS, "STATUS", 0, 0, 0},
+	{BLE_DATA, "BLE_DATA", 0, 0, 0},
+	{LORA_JOIN_FIN, "JOIN_FIN", 0, 0, 0},
+	{LORA_DATA, "LORA_DATA", 0, 0, 0},
+	{LORA_TX_FIN, "TX_FIN", 0, 0, 0},
+};
+
+/**
+ * @brief Add an event to the queue, only called by the producer
+ *
+ * @param type event bit
+ * @param payload event data
+ * @param raised_us time the event was raised
+ * @return true if the event was queued
+ * @return false if the queue is full
+ */
+bool evq_push(uint16_t type, void *payload, uint32_t raised_us)
+{
+	if (!evq_ready)
+	{
+		for (uint32_t idx = 0; idx < EVQ_SIZE; idx++)
+		{
+			evq_slots[idx].seq = idx;
+		}
+		evq_ready = true;
+	}
+
+	uint32_t head = evq_head;
+	evq_slot_s *slot = &evq_slots[head & (EVQ_SIZE - 1)];
+	// Slot is free when the consumer of the last round released it
+	if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != head)
+	{
+		evq_dropped++;
+		return false;
+	}
+	slot->event.type = type;
+	slot->event.payload = payload;
+	slot->event.raised_us = raised_us;
+	__atomic_store_n(&slot->seq, head + 1, __ATOMIC_RELEASE);
+	evq_head = head + 1;
+
+	uint32_t depth = head + 1 - __atomic_load_n(&evq_tail, __ATOMIC_ACQUIRE);
+	if (depth > evq_max_depth)
+	{
+		evq_max_depth = depth;
+	}
+	return true;
+}
+
+/**
+ * @brief Take the oldest event from the queue
+ *
+ * @param event buffer for the event
+ * @return true if an event was taken
+ * @return false if the queue is empty
+ */
+bool evq_pop(app_event_s *event)
+{
+	uint32_t tail = __atomic_load_n(&evq_tail, __ATOMIC_ACQUIRE);
+	while (true)
+	{
+		evq_slot_s *slot = &evq_slots[tail & (EVQ_SIZE - 1)];
+		if (!evq_ready || (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != tail + 1))
+		{
+			// Empty, or another consumer took this entry already
+			if (tail == __atomic_load_n(&evq_tail, __ATOMIC_ACQUIRE))
+			{
+				return false;
+			}
+			tail = __atomic_load_n(&evq_tail, __ATOMIC_ACQUIRE);
+			continue;
+		}
+		// On failure tail is updated with the current value
+		if (__atomic_compare_exchange_n(&evq_tail, &tail, tail + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+		{
+			*event = slot->event;
+			// Release the slot for the next round of the producer
+			__atomic_store_n(&slot->seq, tail + EVQ_SIZE, __ATOMIC_RELEASE);
+			return true;
+		}
+	}
+}
+
+/**
+ * @brief Move the application events from g_task_event_type into the queue
+ * 		Must be called from the loop task only
+ *
+ * @return uint8_t number of events queued
+ */
+uint8_t evq_collect(void)
+{
+	uint16_t mask = 0;
+	for (uint8_t idx = 0; idx < EVQ_NUM_TYPES; idx++)
+	{
+		mask |= evq_stats[idx].type;
+	}
+	uint16_t events = __atomic_fetch_and(&g_task_event_type, (uint16_t)~mask, __ATOMIC_ACQ_REL) & mask;
+	if (events == 0)
+	{
+		return 0;
+	}
+
+	uint32_t now = micros();
+	uint8_t queued = 0;
+	for (uint8_t idx = 0; idx < EVQ_NUM_TYPES; idx++)
+	{
+		uint16_t type = evq_stats[idx].type;
+		if ((events & type) == 0)
+		{
+			continue;
+		}
+		void *payload = NULL;
+		if (type == LORA_DATA)
+		{
+			payload = g_rx_lora_data;
+		}
+		if (evq_push(type, payload, now))
+		{
+			queued++;
+		}
+		else
+		{
+			MYLOG("EVQ", "Queue full, event 0x%04X dropped", type);
+		}
+	}
+	return queued;
+}
+
+/**
+ * @brief Record the latency of an event, called when the handler starts
+ *
+ * @param event the event
+ */
+void evq_handled(app_event_s *event)
+{
+	uint32_t latency = micros() - event->raised_us;
+	for (uint8_t idx = 0; idx < EVQ_NUM_TYPES; idx++)
+	{
+		if (evq_stats[idx].type == event->type)
+		{
+			evq_stats[idx].count++;
+			evq_stats[idx].latency_us += latency;
+			if (latency > evq_stats[idx].max_latency_us)
+			{
+				evq_stats[idx].max_latency_us = latency;
+			}
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Create a compact line with the queue statistics
+ * 		Format: DEPTH=<now>/<max>,DROP=<n>;<type>,<count>,<avg us>,<max us>;...
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void evq_report(char *buff, size_t buff_size)
+{
+	uint32_t depth = evq_head - evq_tail;
+	int len = snprintf(buff, buff_size, "DEPTH=%ld/%ld,DROP=%ld", depth, evq_max_depth, evq_dropped);
+	for (uint8_t idx = 0; idx < EVQ_NUM_TYPES; idx++)
+	{
+		if ((len < 0) || ((size_t)len >= buff_size))
+		{
+			return;
+		}
+		evq_stat_s *stat = &evq_stats[idx];
+		len += snprintf(&buff[len], buff_size - len, ";%s,%ld,%ld,%ld", stat->name, stat->count,
+						stat->count != 0 ? (uint32_t)(stat->latency_us / stat->count) : 0, stat->max_latency_us);
+	}
+}
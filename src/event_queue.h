@@ -0,0 +1,50 @@
+/**
+ * @file event_queue.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Lock-free queue of timestamped application events
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+#include <Arduino.h>
+
+/** Number of queue entries, power of 2 */
+#ifndef EVQ_SIZE
+#define EVQ_SIZE 16
+#endif
+#if (EVQ_SIZE & (EVQ_SIZE - 1)) != 0
+#error "EVQ_SIZE must be a power of 2"
+#endif
+
+/** Number of event types with statistics */
+#define EVQ_NUM_TYPES 5
+
+/** Queued event */
+struct app_event_s
+{
+	uint16_t type;		 // event bit of g_task_event_type
+	void *payload;		 // event data, NULL if none
+	uint32_t raised_us;	 // time the event was raised
+};
+
+/** Statistics of an event type */
+struct evq_stat_s
+{
+	uint16_t type;
+	const char *name;
+	uint32_t count;
+	uint64_t latency_us; // sum of raise to handler start
+	uint32_t max_latency_us;
+};
+
+bool evq_push(uint16_t type, void *payload, uint32_t raised_us);
+bool evq_pop(app_event_s *event);
+uint8_t evq_collect(void);
+void evq_handled(app_event_s *event);
+void evq_report(char *buff, size_t buff_size);
+
+#endif // EVENT_QUEUE_H
@@ -0,0 +1,224 @@
+/**
+ * @file fmt.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Small type safe text formatter with fixed-point decimals, no float, no heap
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "main.h"
+
+/** Powers of 10 for the fixed-point output */
+static const uint32_t fmt_pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+/**
+ * @brief Copy the text up to the next conversion and parse the conversion
+ * 		The format was checked at compile time, so it is not checked again here.
+ *
+ * @param out output buffer
+ * @param fmt format string, moved behind the conversion
+ * @param spec parsed conversion, conv is 0 at the end of the format
+ */
+void fmt_literal(fmt_out_s &out, const char *&fmt, fmt_spec_s &spec)
+{
+	spec = fmt_spec_s{0, 0, 0, false, false};
+	while (*fmt != 0)
+	{
+		if (*fmt != '%')
+		{
+			out.put(*fmt++);
+			continue;
+		}
+		fmt++;
+		if (*fmt == '%')
+		{
+			out.put(*fmt++);
+			continue;
+		}
+		if (*fmt == '0')
+		{
+			spec.zero = true;
+			fmt++;
+		}
+		while ((*fmt >= '0') && (*fmt <= '9'))
+		{
+			spec.width = spec.width * 10 + (*fmt++ - '0');
+		}
+		if (*fmt == '.')
+		{
+			fmt++;
+			spec.has_precision = true;
+			while ((*fmt >= '0') && (*fmt <= '9'))
+			{
+				spec.precision = spec.precision * 10 + (*fmt++ - '0');
+			}
+		}
+		while (*fmt == 'l')
+		{
+			fmt++;
+		}
+		spec.conv = *fmt++;
+		return;
+	}
+}
+
+/**
+ * @brief Write digits from the end of a temp buffer with padding
+ *
+ * @param out output buffer
+ * @param spec conversion with width and zero flag
+ * @param digits digits, last digit first
+ * @param num_digits number of digits
+ * @param negative true to write a minus sign
+ */
+static void fmt_put_digits(fmt_out_s &out, const fmt_spec_s &spec, const char *digits, uint8_t num_digits, bool negative)
+{
+	uint8_t len = num_digits + (negative ? 1 : 0);
+	if (negative && spec.zero)
+	{
+		out.put('-');
+	}
+	for (; len < spec.width; len++)
+	{
+		out.put(spec.zero ? '0' : ' ');
+	}
+	if (negative && !spec.zero)
+	{
+		out.put('-');
+	}
+	while (num_digits != 0)
+	{
+		out.put(digits[--num_digits]);
+	}
+}
+
+/**
+ * @brief Write an integer
+ *
+ * @param out output buffer
+ * @param spec conversion
+ * @param value absolute value
+ * @param negative true to write a minus sign
+ */
+void fmt_put_uint(fmt_out_s &out, const fmt_spec_s &spec, uint32_t value, bool negative)
+{
+	char digits[10];
+	uint8_t num_digits = 0;
+	if ((spec.conv == 'x') || (spec.conv == 'X'))
+	{
+		const char *hex = spec.conv == 'x' ? "0123456789abcdef" : "0123456789ABCDEF";
+		do
+		{
+			digits[num_digits++] = hex[value & 0x0f];
+			value >>= 4;
+		} while (value != 0);
+	}
+	else
+	{
+		do
+		{
+			digits[num_digits++] = '0' + value % 10;
+			value /= 10;
+		} while (value != 0);
+	}
+	fmt_put_digits(out, spec, digits, num_digits, negative);
+}
+
+/**
+ * @brief Write a 64 bit integer, slower, uses the 64 bit division
+ *
+ * @param out output buffer
+ * @param spec conversion
+ * @param value absolute value
+ * @param negative true to write a minus sign
+ */
+void fmt_put_uint64(fmt_out_s &out, const fmt_spec_s &spec, uint64_t value, bool negative)
+{
+	if ((value >> 32) == 0)
+	{
+		fmt_put_uint(out, spec, (uint32_t)value, negative);
+		return;
+	}
+	char digits[20];
+	uint8_t num_digits = 0;
+	bool hex = (spec.conv == 'x') || (spec.conv == 'X');
+	do
+	{
+		uint8_t digit = hex ? value & 0x0f : value % 10;
+		digits[num_digits++] = digit < 10 ? '0' + digit : (spec.conv == 'x' ? 'a' : 'A') + digit - 10;
+		value = hex ? value >> 4 : value / 10;
+	} while (value != 0);
+	fmt_put_digits(out, spec, digits, num_digits, negative);
+}
+
+/**
+ * @brief Write a fixed-point value with the number of decimals of the conversion
+ * 		The value is rounded half away from zero
+ *
+ * @param out output buffer
+ * @param spec conversion, precision is the number of decimals
+ * @param value fixed-point value
+ */
+void fmt_put_fix(fmt_out_s &out, const fmt_spec_s &spec, fmt_fix_s value)
+{
+	uint8_t scale = value.scale > 9 ? 9 : value.scale;
+	uint8_t decimals = spec.has_precision ? spec.precision : scale;
+	if (decimals > 9)
+	{
+		decimals = 9;
+	}
+	bool negative = value.value < 0;
+	uint32_t magnitude = negative ? 0U - (uint32_t)value.value : (uint32_t)value.value;
+
+	// Value in units of the last decimal
+	uint64_t units;
+	if (decimals <= scale)
+	{
+		uint32_t div = fmt_pow10[scale - decimals];
+		units = (magnitude + div / 2) / div;
+	}
+	else
+	{
+		units = (uint64_t)magnitude * fmt_pow10[decimals - scale];
+	}
+	uint64_t integer = units / fmt_pow10[decimals];
+	uint32_t fraction = units % fmt_pow10[decimals];
+
+	// Integer part with the width of the whole number
+	fmt_spec_s int_spec = spec;
+	int_spec.conv = 'u';
+	int_spec.width = spec.width > decimals + (decimals != 0 ? 1 : 0) ? spec.width - decimals - (decimals != 0 ? 1 : 0) : 0;
+	fmt_put_uint64(out, int_spec, integer, negative && (units != 0));
+	if (decimals != 0)
+	{
+		out.put('.');
+		fmt_spec_s frac_spec = {'u', decimals, 0, true, false};
+		fmt_put_uint(out, frac_spec, fraction, false);
+	}
+}
+
+/**
+ * @brief Write a string, width pads on the left
+ *
+ * @param out output buffer
+ * @param spec conversion
+ * @param value string, NULL writes (null)
+ */
+void fmt_put_str(fmt_out_s &out, const fmt_spec_s &spec, const char *value)
+{
+	if (value == NULL)
+	{
+		value = "(null)";
+	}
+	size_t len = strlen(value);
+	for (; len < spec.width; len++)
+	{
+		out.put(' ');
+	}
+	while (*value != 0)
+	{
+		out.put(*value++);
+	}
+}
@@ -0,0 +1,230 @@
+/**
+ * @file fmt.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Small type safe text formatter with fixed-point decimals, no float, no heap
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * FMT(buff, size, "Batt %.2fV", fmt_fix(batt_mv, 3)) writes "Batt 4.01V".
+ * The format string is checked against the argument types at compile time,
+ * a wrong type or a wrong number of arguments fails the build.
+ *
+ * Conversions:
+ * - %d %i %u        integers, optional width and 0 flag (%3d, %02u)
+ * - %x %X           hex, optional width and 0 flag (%02X)
+ * - %c              char
+ * - %s              string
+ * - %.<n>f          fixed-point value from fmt_fix(value, scale), n decimals, rounded
+ * - %%              percent sign
+ * A l length modifier is accepted and ignored, so printf formats can be reused.
+ */
+#ifndef FMT_H
+#define FMT_H
+#include <Arduino.h>
+#include <type_traits>
+
+/** Fixed-point value, value / 10^scale */
+struct fmt_fix_s
+{
+	int32_t value;
+	uint8_t scale;
+};
+
+/**
+ * @brief Create a fixed-point value
+ *
+ * @param value integer value
+ * @param scale number of decimals of value, e.g. 3 for mV -> V, 7 for 1e-7 degrees
+ * @return fmt_fix_s fixed-point value
+ */
+inline fmt_fix_s fmt_fix(int32_t value, uint8_t scale)
+{
+	return fmt_fix_s{value, scale};
+}
+
+/** Output buffer, the text is truncated at the end of the buffer */
+struct fmt_out_s
+{
+	char *buff;
+	size_t size;
+	size_t len;
+
+	void put(char c)
+	{
+		if (len + 1 < size)
+		{
+			buff[len++] = c;
+		}
+	}
+};
+
+/** Parsed conversion */
+struct fmt_spec_s
+{
+	char conv;
+	uint8_t width;
+	uint8_t precision;
+	bool zero;
+	bool has_precision;
+};
+
+/**
+ * Compile-time check of the format string
+ */
+constexpr bool fmt_is_digit(char c)
+{
+	return (c >= '0') && (c <= '9');
+}
+
+/** Index of the conversion character of the spec that starts at i */
+constexpr size_t fmt_spec_end(const char *fmt, size_t i)
+{
+	return (fmt_is_digit(fmt[i]) || (fmt[i] == '.') || (fmt[i] == 'l')) ? fmt_spec_end(fmt, i + 1) : i;
+}
+
+/** Index of the next conversion character, or of the terminating 0 */
+constexpr size_t fmt_find(const char *fmt, size_t i)
+{
+	return fmt[i] == 0 ? i : fmt[i] != '%' ? fmt_find(fmt, i + 1)
+						   : fmt[i + 1] == '%' ? fmt_find(fmt, i + 2)
+											   : fmt_spec_end(fmt, i + 1);
+}
+
+/** Check if a type can be used with a conversion character */
+template <typename T>
+constexpr bool fmt_accepts(char conv)
+{
+	return conv == 's'   ? std::is_same<T, const char *>::value || std::is_same<T, char *>::value
+		   : conv == 'c' ? std::is_same<T, char>::value
+		   : conv == 'f' ? std::is_same<T, fmt_fix_s>::value
+		   : (conv == 'd') || (conv == 'i') || (conv == 'u') || (conv == 'x') || (conv == 'X')
+			   ? (std::is_integral<T>::value || std::is_enum<T>::value) && !std::is_same<T, bool>::value
+			   : false;
+}
+
+/** Argument type list */
+template <typename... T>
+struct fmt_list
+{
+};
+
+/** Only used in decltype, maps the arguments to their types */
+template <typename... T>
+fmt_list<typename std::decay<T>::type...> fmt_types(T &&...);
+
+template <typename L>
+struct fmt_check;
+
+template <>
+struct fmt_check<fmt_list<>>
+{
+	static constexpr bool check(const char *fmt, size_t i)
+	{
+		return fmt[fmt_find(fmt, i)] == 0;
+	}
+};
+
+template <typename T, typename... R>
+struct fmt_check<fmt_list<T, R...>>
+{
+	static constexpr bool check(const char *fmt, size_t i)
+	{
+		return fmt_accepts<T>(fmt[fmt_find(fmt, i)]) && fmt_check<fmt_list<R...>>::check(fmt, fmt_find(fmt, i) + 1);
+	}
+};
+
+/** Fails the build if the format string does not match the arguments */
+template <bool OK>
+inline void fmt_assert(void)
+{
+	static_assert(OK, "Format string does not match the arguments");
+}
+
+/**
+ * Run-time formatting
+ */
+void fmt_literal(fmt_out_s &out, const char *&fmt, fmt_spec_s &spec);
+void fmt_put_uint(fmt_out_s &out, const fmt_spec_s &spec, uint32_t value, bool negative);
+void fmt_put_uint64(fmt_out_s &out, const fmt_spec_s &spec, uint64_t value, bool negative);
+void fmt_put_fix(fmt_out_s &out, const fmt_spec_s &spec, fmt_fix_s value);
+void fmt_put_str(fmt_out_s &out, const fmt_spec_s &spec, const char *value);
+
+template <typename T>
+inline typename std::enable_if<(std::is_integral<T>::value || std::is_enum<T>::value) && (sizeof(T) <= 4)>::type
+fmt_put(fmt_out_s &out, const fmt_spec_s &spec, T value)
+{
+	if (spec.conv == 'c')
+	{
+		out.put((char)value);
+		return;
+	}
+	int32_t value_s = (int32_t)value;
+	bool negative = std::is_signed<T>::value && (spec.conv == 'd' || spec.conv == 'i') && (value_s < 0);
+	fmt_put_uint(out, spec, negative ? 0U - (uint32_t)value_s : (uint32_t)value, negative);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && (sizeof(T) == 8)>::type
+fmt_put(fmt_out_s &out, const fmt_spec_s &spec, T value)
+{
+	bool negative = std::is_signed<T>::value && (spec.conv == 'd' || spec.conv == 'i') && ((int64_t)value < 0);
+	fmt_put_uint64(out, spec, negative ? 0ULL - (uint64_t)value : (uint64_t)value, negative);
+}
+
+inline void fmt_put(fmt_out_s &out, const fmt_spec_s &spec, fmt_fix_s value)
+{
+	fmt_put_fix(out, spec, value);
+}
+
+inline void fmt_put(fmt_out_s &out, const fmt_spec_s &spec, const char *value)
+{
+	fmt_put_str(out, spec, value);
+}
+
+inline void fmt_args(fmt_out_s &out, const char *fmt)
+{
+	fmt_spec_s spec;
+	fmt_literal(out, fmt, spec);
+}
+
+template <typename T, typename... Args>
+inline void fmt_args(fmt_out_s &out, const char *fmt, T value, Args... args)
+{
+	fmt_spec_s spec;
+	fmt_literal(out, fmt, spec);
+	fmt_put(out, spec, value);
+	fmt_args(out, fmt, args...);
+}
+
+/**
+ * @brief Format into a buffer, use the FMT macro to get the compile-time check
+ *
+ * @return int length of the text in the buffer
+ */
+template <typename... Args>
+inline int fmt_format(char *buff, size_t size, const char *fmt, Args... args)
+{
+	fmt_out_s out = {buff, size, 0};
+	fmt_args(out, fmt, args...);
+	if (size != 0)
+	{
+		buff[out.len] = 0;
+	}
+	return out.len;
+}
+
+/**
+ * @brief Format into a buffer, the format string must be a string literal
+ *
+ * @param buff buffer for the text
+ * @param size size of the buffer
+ * @param fmt format string
+ * @return int length of the text in the buffer
+ */
+#define FMT(buff, size, fmt, ...)                                                                   \
+	(fmt_assert<fmt_check<decltype(fmt_types(__VA_ARGS__))>::check(fmt, 0)>(), \
+	 fmt_format(buff, size, fmt, ##__VA_ARGS__))
+
+#endif // FMT_H
@@ -0,0 +1,348 @@
+/**
+ * @file gpio_loop.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief IO slot loopback test with GPIOTE, PPI and TIMER4
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Needs a loopback plug that connects the pins in pairs (GPIO_LOOP_PARTNER).
+ * All pins are inputs with pull-down. One pin at a time (walking one) is set
+ * high by a GPIOTE task, triggered through PPI by a compare event of TIMER4.
+ * Rising edges on all other pins are captured at the same time by GPIOTE
+ * events, each one stores the timer into its own CC register through PPI.
+ * So every step checks the whole pin matrix: the partner must follow (else
+ * OPEN), no other pin may follow (else SHORT), and the delay of the partner
+ * is the propagation time in 62.5 ns steps, including about 2 steps of PPI
+ * and GPIOTE latency. Pins that are high while all pins are pulled down or
+ * that stay low while driven are shorted to VDD or GND.
+ * Timing is done by the hardware, the task can be preempted without error.
+ * The test runs only with AT+TEST=GPIO and not if a RAK14000 was found, its
+ * buttons are on WB_IO3, WB_IO5 and WB_IO6.
+ */
+#include "main.h"
+#include <nrf_soc.h>
+#include <nrf_sdm.h>
+
+static const uint8_t gpio_loop_pins[] = GPIO_LOOP_PINS;
+static const char *gpio_loop_names[] = GPIO_LOOP_NAMES;
+static const uint8_t gpio_loop_partner[] = GPIO_LOOP_PARTNER;
+
+static_assert(sizeof(gpio_loop_pins) == GPIO_LOOP_NUM, "GPIO_LOOP_PINS must have GPIO_LOOP_NUM pins");
+static_assert(sizeof(gpio_loop_partner) == GPIO_LOOP_NUM, "GPIO_LOOP_PARTNER must have GPIO_LOOP_NUM entries");
+static_assert(GPIO_LOOP_NUM <= 6, "TIMER4 has 6 CC registers, 1 for the start and 1 per captured pin");
+
+/** TIMER4 compare value for the rising edge, 1 us after the timer start */
+#define GPIO_LOOP_START_TICKS 16
+
+/** Result of a pin */
+struct gpio_loop_pin_s
+{
+	uint8_t status;		// gpio_loop_status_e
+	uint8_t shorts;		// bit mask of the pins that followed besides the partner
+	uint16_t delay_ns;	// propagation time to the partner
+};
+
+static gpio_loop_pin_s gpio_loop_result[GPIO_LOOP_NUM];
+/** Duration of the last run in us, 0 if the test did not run */
+static uint32_t gpio_loop_time_us = 0;
+
+/**
+ * @brief Get the port of a pin
+ *
+ * @param pin index in gpio_loop_pins
+ * @return NRF_GPIO_Type* port
+ */
+static NRF_GPIO_Type *gpio_loop_port(uint8_t pin)
+{
+	return g_ADigitalPinMap[gpio_loop_pins[pin]] >= 32 ? NRF_P1 : NRF_P0;
+}
+
+/**
+ * @brief Get the bit of a pin in its port
+ *
+ * @param pin index in gpio_loop_pins
+ * @return uint32_t pin number in the port
+ */
+static uint32_t gpio_loop_bit(uint8_t pin)
+{
+	return g_ADigitalPinMap[gpio_loop_pins[pin]] & 31;
+}
+
+/**
+ * @brief Read the level of a pin
+ *
+ * @param pin index in gpio_loop_pins
+ * @return true if high
+ */
+static bool gpio_loop_level(uint8_t pin)
+{
+	return (gpio_loop_port(pin)->IN >> gpio_loop_bit(pin)) & 1;
+}
+
+/**
+ * @brief Pin select bits of a GPIOTE CONFIG register
+ *
+ * @param pin index in gpio_loop_pins
+ * @return uint32_t PSEL and PORT bits
+ */
+static uint32_t gpio_loop_psel(uint8_t pin)
+{
+	uint32_t nrf_pin = g_ADigitalPinMap[gpio_loop_pins[pin]];
+	return ((nrf_pin & 31) << GPIOTE_CONFIG_PSEL_Pos) | ((nrf_pin >> 5) << GPIOTE_CONFIG_PORT_Pos);
+}
+
+/**
+ * @brief Connect an event to a task, through the SoftDevice if it is enabled
+ *
+ * @param ch PPI channel
+ * @param eep event register
+ * @param tep task register
+ */
+static void gpio_loop_ppi(uint8_t ch, volatile uint32_t *eep, volatile uint32_t *tep)
+{
+	uint8_t sd_enabled = 0;
+	sd_softdevice_is_enabled(&sd_enabled);
+	if (sd_enabled)
+	{
+		sd_ppi_channel_assign(ch, eep, tep);
+	}
+	else
+	{
+		NRF_PPI->CH[ch].EEP = (uint32_t)eep;
+		NRF_PPI->CH[ch].TEP = (uint32_t)tep;
+	}
+}
+
+/**
+ * @brief Enable or disable PPI channels, through the SoftDevice if it is enabled
+ *
+ * @param mask channels
+ * @param enable true to enable
+ */
+static void gpio_loop_ppi_enable(uint32_t mask, bool enable)
+{
+	uint8_t sd_enabled = 0;
+	sd_softdevice_is_enabled(&sd_enabled);
+	if (sd_enabled)
+	{
+		if (enable)
+		{
+			sd_ppi_channel_enable_set(mask);
+		}
+		else
+		{
+			sd_ppi_channel_enable_clr(mask);
+		}
+	}
+	else if (enable)
+	{
+		NRF_PPI->CHENSET = mask;
+	}
+	else
+	{
+		NRF_PPI->CHENCLR = mask;
+	}
+}
+
+/**
+ * @brief Find free GPIOTE channels, channels used by attachInterrupt() are kept
+ *
+ * @param channels array for GPIO_LOOP_NUM channel numbers
+ * @return true if enough channels are free
+ */
+static bool gpio_loop_channels(uint8_t *channels)
+{
+	uint8_t found = 0;
+	for (int8_t ch = GPIOTE_CH_NUM - 1; (ch >= 0) && (found < GPIO_LOOP_NUM); ch--)
+	{
+		if ((NRF_GPIOTE->CONFIG[ch] & GPIOTE_CONFIG_MODE_Msk) == (GPIOTE_CONFIG_MODE_Disabled << GPIOTE_CONFIG_MODE_Pos))
+		{
+			channels[found++] = ch;
+		}
+	}
+	return found == GPIO_LOOP_NUM;
+}
+
+/**
+ * @brief Drive one pin high and capture the edges on all other pins
+ *
+ * @param drv index of the driven pin
+ * @param channels GPIOTE channels, the first one drives
+ */
+static void gpio_loop_step(uint8_t drv, const uint8_t *channels)
+{
+	const uint32_t ppi_mask = ((1UL << GPIO_LOOP_NUM) - 1) << GPIO_LOOP_PPI_FIRST;
+	uint8_t receiver[GPIO_LOOP_NUM - 1];
+
+	// Driver, low until the compare event sets it
+	NRF_GPIOTE->CONFIG[channels[0]] = (GPIOTE_CONFIG_MODE_Task << GPIOTE_CONFIG_MODE_Pos) | gpio_loop_psel(drv) |
+									  (GPIOTE_CONFIG_OUTINIT_Low << GPIOTE_CONFIG_OUTINIT_Pos);
+	gpio_loop_ppi(GPIO_LOOP_PPI_FIRST, &NRF_TIMER4->EVENTS_COMPARE[0], &NRF_GPIOTE->TASKS_SET[channels[0]]);
+
+	// Receivers, a rising edge captures the timer
+	uint8_t num = 0;
+	for (uint8_t rcv = 0; rcv < GPIO_LOOP_NUM; rcv++)
+	{
+		if (rcv == drv)
+		{
+			continue;
+		}
+		uint8_t ch = channels[num + 1];
+		NRF_GPIOTE->CONFIG[ch] = (GPIOTE_CONFIG_MODE_Event << GPIOTE_CONFIG_MODE_Pos) | gpio_loop_psel(rcv) |
+								 (GPIOTE_CONFIG_POLARITY_LoToHi << GPIOTE_CONFIG_POLARITY_Pos);
+		NRF_GPIOTE->EVENTS_IN[ch] = 0;
+		gpio_loop_ppi(GPIO_LOOP_PPI_FIRST + num + 1, &NRF_GPIOTE->EVENTS_IN[ch], &NRF_TIMER4->TASKS_CAPTURE[num + 1]);
+		receiver[num++] = rcv;
+	}
+
+	// 16 MHz, 32 bit, edge at GPIO_LOOP_START_TICKS
+	NRF_TIMER4->TASKS_STOP = 1;
+	NRF_TIMER4->MODE = TIMER_MODE_MODE_Timer;
+	NRF_TIMER4->BITMODE = TIMER_BITMODE_BITMODE_32Bit;
+	NRF_TIMER4->PRESCALER = 0;
+	NRF_TIMER4->SHORTS = 0;
+	NRF_TIMER4->CC[0] = GPIO_LOOP_START_TICKS;
+	NRF_TIMER4->EVENTS_COMPARE[0] = 0;
+	NRF_TIMER4->TASKS_CLEAR = 1;
+	gpio_loop_ppi_enable(ppi_mask, true);
+	NRF_TIMER4->TASKS_START = 1;
+	delayMicroseconds(GPIO_LOOP_WINDOW_US);
+	NRF_TIMER4->TASKS_STOP = 1;
+	gpio_loop_ppi_enable(ppi_mask, false);
+
+	// Evaluate
+	gpio_loop_pin_s *result = &gpio_loop_result[drv];
+	bool partner_seen = gpio_loop_partner[drv] == drv;
+	for (uint8_t idx = 0; idx < num; idx++)
+	{
+		if (NRF_GPIOTE->EVENTS_IN[channels[idx + 1]] == 0)
+		{
+			continue;
+		}
+		if (receiver[idx] == gpio_loop_partner[drv])
+		{
+			partner_seen = true;
+			uint32_t ticks = NRF_TIMER4->CC[idx + 1] - GPIO_LOOP_START_TICKS;
+			result->delay_ns = ticks * 125 / 2 > UINT16_MAX ? UINT16_MAX : ticks * 125 / 2;
+		}
+		else
+		{
+			result->shorts |= 1 << receiver[idx];
+		}
+	}
+	if (result->status == GPIO_LOOP_OK)
+	{
+		if (!gpio_loop_level(drv))
+		{
+			result->status = GPIO_LOOP_LOW;
+		}
+		else if (result->shorts != 0)
+		{
+			result->status = GPIO_LOOP_SHORT;
+		}
+		else if (!partner_seen)
+		{
+			result->status = GPIO_LOOP_OPEN;
+		}
+	}
+
+	// Back to inputs, pull the lines low before the pins are released
+	NRF_GPIOTE->TASKS_CLR[channels[0]] = 1;
+	delayMicroseconds(2);
+	for (uint8_t idx = 0; idx < GPIO_LOOP_NUM; idx++)
+	{
+		NRF_GPIOTE->CONFIG[channels[idx]] = 0;
+		NRF_GPIOTE->EVENTS_IN[channels[idx]] = 0;
+	}
+}
+
+/**
+ * @brief Run the loopback test on all pins
+ *
+ * @return true if all pins are connected to their partner and to no other pin
+ * @return false if a pin failed or the timer channels are not available
+ */
+bool gpio_loop_run(void)
+{
+	uint32_t start = micros();
+	uint8_t channels[GPIO_LOOP_NUM];
+	memset(gpio_loop_result, 0, sizeof(gpio_loop_result));
+	gpio_loop_time_us = 0;
+	if (!gpio_loop_channels(channels))
+	{
+		MYLOG("GPIO", "Not enough free GPIOTE channels");
+		return false;
+	}
+
+	// All pins inputs with pull-down, the configuration is restored at the end
+	uint32_t saved_cnf[GPIO_LOOP_NUM];
+	for (uint8_t pin = 0; pin < GPIO_LOOP_NUM; pin++)
+	{
+		saved_cnf[pin] = gpio_loop_port(pin)->PIN_CNF[gpio_loop_bit(pin)];
+		gpio_loop_port(pin)->PIN_CNF[gpio_loop_bit(pin)] = (GPIO_PIN_CNF_DIR_Input << GPIO_PIN_CNF_DIR_Pos) |
+														   (GPIO_PIN_CNF_INPUT_Connect << GPIO_PIN_CNF_INPUT_Pos) |
+														   (GPIO_PIN_CNF_PULL_Pulldown << GPIO_PIN_CNF_PULL_Pos);
+	}
+	delayMicroseconds(10);
+	for (uint8_t pin = 0; pin < GPIO_LOOP_NUM; pin++)
+	{
+		if (gpio_loop_level(pin))
+		{
+			gpio_loop_result[pin].status = GPIO_LOOP_HIGH;
+		}
+	}
+
+	for (uint8_t drv = 0; drv < GPIO_LOOP_NUM; drv++)
+	{
+		gpio_loop_step(drv, channels);
+	}
+
+	for (uint8_t pin = 0; pin < GPIO_LOOP_NUM; pin++)
+	{
+		gpio_loop_port(pin)->PIN_CNF[gpio_loop_bit(pin)] = saved_cnf[pin];
+	}
+	gpio_loop_time_us = micros() - start;
+
+	bool loop_ok = true;
+	for (uint8_t pin = 0; pin < GPIO_LOOP_NUM; pin++)
+	{
+		loop_ok &= gpio_loop_result[pin].status == GPIO_LOOP_OK;
+	}
+	return loop_ok;
+}
+
+/**
+ * @brief Create a compact line with the result of the last run
+ * 		Format: TIME=<us>;<pin>=<OK|OPEN|SHORT|HIGH|LOW>,<delay ns>[,<shorted pins>];...
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void gpio_loop_report(char *buff, size_t buff_size)
+{
+	static const char *status_names[] = {"OK", "OPEN", "SHORT", "HIGH", "LOW"};
+	int len = snprintf(buff, buff_size, "TIME=%ld", gpio_loop_time_us);
+	if (gpio_loop_time_us == 0)
+	{
+		return;
+	}
+	for (uint8_t pin = 0; pin < GPIO_LOOP_NUM; pin++)
+	{
+		if ((len < 0) || ((size_t)len >= buff_size))
+		{
+			return;
+		}
+		const gpio_loop_pin_s *result = &gpio_loop_result[pin];
+		len += snprintf(&buff[len], buff_size - len, ";%s=%s,%d", gpio_loop_names[pin], status_names[result->status],
+						result->delay_ns);
+		for (uint8_t other = 0; other < GPIO_LOOP_NUM; other++)
+		{
+			if (((result->shorts & (1 << other)) != 0) && (len >= 0) && ((size_t)len < buff_size))
+			{
+				len += snprintf(&buff[len], buff_size - len, ",%s", gpio_loop_names[other]);
+			}
+		}
+	}
+}
@@ -0,0 +1,52 @@
+/**
+ * @file gpio_loop.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief IO slot loopback test with GPIOTE, PPI and TIMER4
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef GPIO_LOOP_H
+#define GPIO_LOOP_H
+#include <Arduino.h>
+
+/** Pins of the test, WB_IO2 is not used, it switches the 3V3_S rail */
+#ifndef GPIO_LOOP_PINS
+#define GPIO_LOOP_PINS {WB_IO1, WB_IO3, WB_IO4, WB_IO5, WB_IO6}
+#endif
+/** Names of the pins for the report */
+#ifndef GPIO_LOOP_NAMES
+#define GPIO_LOOP_NAMES {"IO1", "IO3", "IO4", "IO5", "IO6"}
+#endif
+/** Index of the pin each pin is connected to by the loopback plug, own index if not connected */
+#ifndef GPIO_LOOP_PARTNER
+#define GPIO_LOOP_PARTNER {1, 0, 3, 2, 4}
+#endif
+/** Number of pins, max 6 (1 driven + 5 captured with the 6 CC registers of TIMER4) */
+#define GPIO_LOOP_NUM 5
+
+/** First of the GPIO_LOOP_NUM PPI channels, 0 to 16 are free for the application with the SoftDevice */
+#ifndef GPIO_LOOP_PPI_FIRST
+#define GPIO_LOOP_PPI_FIRST 8
+#endif
+/** Time an edge is waited for after the pin was driven, in us */
+#ifndef GPIO_LOOP_WINDOW_US
+#define GPIO_LOOP_WINDOW_US 50
+#endif
+
+/** Result of a pin */
+enum gpio_loop_status_e
+{
+	GPIO_LOOP_OK,	 // partner followed, no other pin
+	GPIO_LOOP_OPEN,	 // partner did not follow
+	GPIO_LOOP_SHORT, // other pins followed
+	GPIO_LOOP_HIGH,	 // high while all pins were pulled down
+	GPIO_LOOP_LOW,	 // stayed low while driven high
+};
+
+bool gpio_loop_run(void);
+void gpio_loop_report(char *buff, size_t buff_size);
+
+#endif // GPIO_LOOP_H
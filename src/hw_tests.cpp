@@ -0,0 +1,526 @@
+/**
+ * @file hw_tests.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Single hardware checks, used at boot and by AT commands
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "main.h"
+#include <radio/radio.h>
+#include "i2c_ident.h"
+
+/** Number of I2C devices found */
+uint8_t i2c_num_dev = 0;
+
+/** Addresses of the I2C devices found */
+uint8_t i2c_found_addr[I2C_MAX_FOUND];
+
+/** Module names of the I2C devices found, NULL if unknown */
+const char *i2c_found_name[I2C_MAX_FOUND];
+
+/** Register reads per clock in the margin test */
+#define I2C_MARGIN_READS 32
+/** Bytes per register read in the margin test */
+#define I2C_MARGIN_BYTES 4
+
+/** Clocks for the margin test, the nRF52 TWIM supports only these three */
+static const uint32_t i2c_margin_clocks[] = {100000, 250000, 400000};
+
+/** Highest clock without errors per device, 0 if it failed at all clocks */
+static uint32_t i2c_margin[I2C_MAX_FOUND];
+
+/** Flag if the register content was stable, otherwise only ACK and length are checked */
+static bool i2c_margin_data[I2C_MAX_FOUND];
+
+/**
+ * @brief Check for the RAK1921 OLED and write the header
+ *
+ * @return true if OLED was found
+ * @return false if no OLED was found
+ */
+bool test_oled(void)
+{
+	TRACE_SCOPE("oled_init");
+	has_rak1921 = init_rak1921();
+	result_set(RESULT_OLED, has_rak1921 ? 1 : 0);
+	if (has_rak1921)
+	{
+		rak1921_write_header((char *)"WisBlock Node");
+		result_subscribe(rak1921_result_view);
+	}
+	else
+	{
+		MYLOG("OLED", "No OLED found");
+	}
+	return has_rak1921;
+}
+
+/**
+ * @brief Check for the RAK14000 EPD
+ *
+ * @return true if EPD was found
+ * @return false if no EPD was found
+ */
+bool test_epd(void)
+{
+	TRACE_SCOPE("epd_init");
+	has_rak14000 = init_rak14000();
+	result_set(RESULT_EPD, has_rak14000 ? 1 : 0);
+	if (has_rak14000)
+	{
+		result_subscribe(rak14000_result_view);
+	}
+	if (has_rak1921)
+	{
+		if (has_rak14000)
+		{
+			sprintf(disp_txt, "Found RAK14000 EPD");
+			rak1921_add_line(disp_txt);
+		}
+		else
+		{
+			sprintf(disp_txt, "No RAK14000 EPD");
+			rak1921_add_line(disp_txt);
+		}
+	}
+
+	if (has_rak14000)
+	{
+		MYLOG("EPD", "Found RAK14000 EPD");
+	}
+	else
+	{
+		MYLOG("EPD", "No RAK14000 EPD");
+	}
+	return has_rak14000;
+}
+
+/**
+ * @brief Scan the I2C interface for devices
+ *
+ * @return uint8_t number of devices found
+ */
+uint8_t test_i2c(void)
+{
+	TRACE_SCOPE("i2c_scan");
+	byte error;
+	uint8_t num_dev = 0;
+
+	Wire.begin();
+	// Some modules support only 100kHz
+	i2c_bus_take(I2C_ALL_DEVICES);
+	for (byte address = 1; address < 127; address++)
+	{
+		Wire.beginTransmission(address);
+		error = Wire.endTransmission();
+		if (error == 0)
+		{
+			const char *name = i2c_identify(address);
+			MYLOG("SCAN", "Found sensor at I2C1 0x%02X %s", address, name != NULL ? name : "unknown");
+			if (address == 0x3c)
+			{
+				has_rak1921 = true;
+			}
+			if (has_rak1921)
+			{
+				if (name != NULL)
+				{
+					snprintf(disp_txt, 32, "0x%02X %s", address, name);
+				}
+				else
+				{
+					sprintf(disp_txt, "Found I2C device 0x%02X", address);
+				}
+				rak1921_add_line(disp_txt);
+			}
+			if (address == 0x42)
+			{
+				has_rak12500 = true;
+			}
+			if (num_dev < I2C_MAX_FOUND)
+			{
+				i2c_found_addr[num_dev] = address;
+				i2c_found_name[num_dev] = name;
+			}
+			num_dev++;
+		}
+	}
+	i2c_bus_give();
+	MYLOG("SCAN", "Found %d I2C devices", num_dev);
+	if (has_rak1921)
+	{
+		sprintf(disp_txt, "Found %d I2C devices", num_dev);
+		rak1921_add_line(disp_txt);
+	}
+	i2c_num_dev = num_dev;
+	result_set(RESULT_I2C, num_dev);
+	return num_dev;
+}
+
+/**
+ * @brief Fletcher-16 checksum of a register block
+ *
+ * @param data register content
+ * @param len number of bytes
+ * @return uint16_t checksum
+ */
+static uint16_t i2c_checksum(uint8_t *data, uint8_t len)
+{
+	uint16_t sum1 = 0;
+	uint16_t sum2 = 0;
+	for (uint8_t idx = 0; idx < len; idx++)
+	{
+		sum1 = (sum1 + data[idx]) % 255;
+		sum2 = (sum2 + sum1) % 255;
+	}
+	return (sum2 << 8) | sum1;
+}
+
+/**
+ * @brief Find the highest clock each found I2C device works without errors
+ * 		The reference checksum is read at 100kHz. For each clock the register block
+ * 		is read I2C_MARGIN_READS times and compared with the reference.
+ * 		Devices with changing register content are only checked for ACK and length.
+ *
+ * @return true if all devices work at least at 100kHz
+ * @return false if a device failed or no devices were found
+ */
+bool test_i2c_margin(void)
+{
+	TRACE_SCOPE("i2c_margin");
+	uint8_t num_dev = i2c_num_dev < I2C_MAX_FOUND ? i2c_num_dev : I2C_MAX_FOUND;
+	uint8_t data[I2C_MARGIN_BYTES];
+	bool all_ok = num_dev != 0;
+
+	i2c_bus_take(I2C_ALL_DEVICES);
+	for (uint8_t dev = 0; dev < num_dev; dev++)
+	{
+		uint8_t address = i2c_found_addr[dev];
+
+		// Reference read at the lowest clock, twice to see if the content is stable
+		i2c_bus_set_clock(i2c_margin_clocks[0]);
+		uint16_t reference = 0;
+		bool stable = false;
+		if (i2c_bus_read(address, 0x00, data, I2C_MARGIN_BYTES))
+		{
+			reference = i2c_checksum(data, I2C_MARGIN_BYTES);
+			stable = i2c_bus_read(address, 0x00, data, I2C_MARGIN_BYTES) && (i2c_checksum(data, I2C_MARGIN_BYTES) == reference);
+		}
+
+		uint32_t margin = 0;
+		for (uint8_t clk = 0; clk < sizeof(i2c_margin_clocks) / sizeof(i2c_margin_clocks[0]); clk++)
+		{
+			i2c_bus_set_clock(i2c_margin_clocks[clk]);
+			uint16_t errors = 0;
+			for (uint16_t read = 0; read < I2C_MARGIN_READS; read++)
+			{
+				if (!i2c_bus_read(address, 0x00, data, I2C_MARGIN_BYTES))
+				{
+					errors++;
+				}
+				else if (stable && (i2c_checksum(data, I2C_MARGIN_BYTES) != reference))
+				{
+					errors++;
+				}
+			}
+			if (errors != 0)
+			{
+				MYLOG("MARGIN", "0x%02X %d errors at %ldkHz", address, errors, i2c_margin_clocks[clk] / 1000);
+				break;
+			}
+			margin = i2c_margin_clocks[clk];
+		}
+		i2c_margin[dev] = margin;
+		i2c_margin_data[dev] = stable;
+		if (margin == 0)
+		{
+			all_ok = false;
+		}
+		MYLOG("MARGIN", "0x%02X max %ldkHz%s", address, margin / 1000, stable ? "" : " (ACK only)");
+	}
+	i2c_bus_give();
+
+	if (has_rak1921)
+	{
+		for (uint8_t dev = 0; dev < num_dev; dev++)
+		{
+			sprintf(disp_txt, "0x%02X max %ldkHz", i2c_found_addr[dev], i2c_margin[dev] / 1000);
+			rak1921_add_line(disp_txt);
+		}
+	}
+	return all_ok;
+}
+
+/**
+ * @brief Create a compact line with the clock margin of all I2C devices
+ * 		Format: 0x3C=400,0x42=400,0x18=250A,0x44=0
+ * 		Clock in kHz, 0 = failed at 100kHz, A = only ACK checked (register content not stable)
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void get_i2c_margin_line(char *buff, size_t buff_size)
+{
+	uint8_t num_dev = i2c_num_dev < I2C_MAX_FOUND ? i2c_num_dev : I2C_MAX_FOUND;
+	size_t len = 0;
+	buff[0] = 0;
+	for (uint8_t dev = 0; (dev < num_dev) && (len < buff_size); dev++)
+	{
+		len += snprintf(&buff[len], buff_size - len, "%s0x%02X=%ld%s", dev == 0 ? "" : ",",
+						i2c_found_addr[dev], i2c_margin[dev] / 1000, i2c_margin_data[dev] ? "" : "A");
+	}
+}
+
+/**
+ * @brief Create a compact line with all I2C devices found
+ * 		Format: 0x3C=RAK1921 SSD1306,0x76=RAK1906 BME680,0x33=?
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void get_i2c_device_line(char *buff, size_t buff_size)
+{
+	uint8_t num_dev = i2c_num_dev < I2C_MAX_FOUND ? i2c_num_dev : I2C_MAX_FOUND;
+	size_t len = 0;
+	buff[0] = 0;
+	for (uint8_t dev = 0; (dev < num_dev) && (len < buff_size); dev++)
+	{
+		len += snprintf(&buff[len], buff_size - len, "%s0x%02X=%s", dev == 0 ? "" : ",",
+						i2c_found_addr[dev], i2c_found_name[dev] != NULL ? i2c_found_name[dev] : "?");
+	}
+}
+
+/**
+ * @brief Check the RAK12500 GNSS module
+ * 		First call initializes the module, following calls try to get a location
+ *
+ * @return true if module is initialized or location was found
+ * @return false if no module or no location
+ */
+bool test_gnss(void)
+{
+	if (!has_rak12500)
+	{
+		result_set(RESULT_GNSS, 2);
+		return false;
+	}
+	if (gnss_option == NO_GNSS_INIT)
+	{
+		// Setup the GNSS module with RAK specific settings
+		TRACE_SCOPE("gnss_init");
+		has_rak12500 = init_gnss();
+		result_set(RESULT_GNSS, has_rak12500 ? 1 : 2);
+		return has_rak12500;
+	}
+	bool gnss_ok = poll_gnss();
+	result_set(RESULT_GNSS, gnss_ok ? 1 : 0);
+	return gnss_ok;
+}
+
+/**
+ * @brief Write and read back the settings in the flash file system
+ *
+ * @return true if both Write-Read tests were successful
+ * @return false if a Write-Read test failed
+ */
+bool test_flash(void)
+{
+	TRACE_SCOPE("flash_test");
+	bool flash_success;
+
+	// Write-Read Flash test
+	MYLOG("FLASH", "Flash Write-Read test #1");
+
+	if (save_settings())
+	{
+		flash_success = true;
+		MYLOG("FLASH", "Flash Write-Read test #1 success");
+		if (has_rak1921)
+		{
+			sprintf(disp_txt, "Flash Write-Read test #1 success");
+			rak1921_add_line(disp_txt);
+		}
+	}
+	else
+	{
+		flash_success = false;
+		MYLOG("FLASH", "Flash Write-Read test #1 failed");
+		if (has_rak1921)
+		{
+			sprintf(disp_txt, "Flash Write-Read test #1 failed");
+			rak1921_add_line(disp_txt);
+		}
+	}
+	MYLOG("FLASH", "Read send time from flash %ld", g_lorawan_settings.send_repeat_time);
+
+	MYLOG("FLASH", "Flash Write-Read test #2");
+	g_lorawan_settings.send_repeat_time = 60000;
+
+	if (save_settings())
+	{
+		flash_success = true;
+		MYLOG("FLASH", "Flash Write-Read test #2 success");
+		if (has_rak1921)
+		{
+			sprintf(disp_txt, "Flash Write-Read test #2 success");
+			rak1921_add_line(disp_txt);
+		}
+	}
+	else
+	{
+		flash_success = false;
+		MYLOG("FLASH", "Flash Write-Read test #2 failed");
+		if (has_rak1921)
+		{
+			sprintf(disp_txt, "Flash Write-Read test #2 failed");
+			rak1921_add_line(disp_txt);
+		}
+	}
+	result_set(RESULT_FLASH, flash_success ? 1 : 0);
+	return flash_success;
+}
+
+/**
+ * @brief Probe the SPI slot for a flash chip (RAK15001) and report its JEDEC ID, the chip content is not touched
+ *
+ * @return true if a chip was found
+ * @return false if no chip was found
+ */
+bool probe_sflash(void)
+{
+	char line[96];
+	has_rak15001 = init_rak15001();
+	if (!has_rak15001)
+	{
+		result_set(RESULT_SFLASH, 0);
+		MYLOG("SFLASH", "No SPI flash%s", has_rak14000 ? ", slot used by RAK14000" : "");
+		return false;
+	}
+	result_set(RESULT_SFLASH, 3);
+	rak15001_report(line, sizeof(line));
+	MYLOG("SFLASH", "%s", line);
+	return true;
+}
+
+/**
+ * @brief Probe the SPI slot for a flash chip (RAK15001) and measure erase, program and read throughput
+ *
+ * @return true if a chip was found and the data read back matches
+ * @return false if no chip was found or the test failed
+ */
+bool test_sflash(void)
+{
+	TRACE_SCOPE("sflash_test");
+	char line[96];
+	if (!probe_sflash())
+	{
+		return false;
+	}
+	bool sflash_ok = rak15001_throughput();
+	result_set(RESULT_SFLASH, sflash_ok ? 1 : 2);
+	rak15001_report(line, sizeof(line));
+	MYLOG("SFLASH", "%s", line);
+	if (has_rak1921)
+	{
+		snprintf(disp_txt, DISP_TXT_SIZE, "SPI flash %s", sflash_ok ? "OK" : "failed");
+		rak1921_add_line(disp_txt);
+	}
+	return sflash_ok;
+}
+
+/**
+ * @brief IO slot loopback test, needs the loopback plug
+ *
+ * @return true if all pins are connected to their partner and to no other pin
+ * @return false if a pin failed or a RAK14000 is in the slot
+ */
+bool test_gpio(void)
+{
+	TRACE_SCOPE("gpio_loop");
+	if (has_rak14000)
+	{
+		MYLOG("GPIO", "Slot used by RAK14000");
+		return false;
+	}
+	char line[128];
+	bool gpio_ok = gpio_loop_run();
+	gpio_loop_report(line, sizeof(line));
+	MYLOG("GPIO", "%s", line);
+	if (has_rak1921)
+	{
+		snprintf(disp_txt, DISP_TXT_SIZE, "GPIO loopback %s", gpio_ok ? "OK" : "failed");
+		rak1921_add_line(disp_txt);
+	}
+	return gpio_ok;
+}
+
+/**
+ * @brief Check connection to SX126x
+ * 		After power on the sync word should be 2414. 4434 could be possible on a restart (private network syncword)
+ * 		If we got something else, something is wrong.
+ *
+ * @return true if the sync word is valid
+ * @return false if the sync word is invalid
+ */
+bool test_lora(void)
+{
+	TRACE_SCOPE("lora_check");
+	uint16_t readSyncWord = 0;
+	bool lora_chip_ok;
+
+	SX126xReadRegisters(REG_LR_SYNCWORD, (uint8_t *)&readSyncWord, 2);
+
+	MYLOG("SX1262", "SyncWord = %04X", readSyncWord);
+	if (has_rak1921)
+	{
+		sprintf(disp_txt, "SyncWord = %04X", readSyncWord);
+		rak1921_add_line(disp_txt);
+	}
+
+	if ((readSyncWord == 0x2414) || (readSyncWord == 0x4434))
+	{
+		lora_chip_ok = true;
+		MYLOG("SX1262", "LoRa transceiver ok");
+		if (has_rak1921)
+		{
+			sprintf(disp_txt, "LoRa transceiver ok");
+			rak1921_add_line(disp_txt);
+		}
+	}
+	else
+	{
+		lora_chip_ok = false;
+		MYLOG("SX1262", "SyncWord is incorrect, potential problem in SPI setup or LoRa transceiver");
+		if (has_rak1921)
+		{
+			sprintf(disp_txt, "SX1262 problem (SPI or LoRa chip");
+			rak1921_add_line(disp_txt);
+		}
+	}
+	result_set(RESULT_LORA, lora_chip_ok ? 1 : 0);
+	return lora_chip_ok;
+}
+
+/**
+ * @brief Read the battery voltage, average of 10 readings
+ *
+ * @return float battery voltage in mV
+ */
+float test_battery(void)
+{
+	TRACE_SCOPE("battery");
+	float batt_level_f = 0.0;
+	for (int readings = 0; readings < 10; readings++)
+	{
+		batt_level_f += read_batt();
+	}
+	batt_level_f = batt_level_f / 10;
+	result_set(RESULT_BATT, (int32_t)batt_level_f);
+	char batt_str[12];
+	FMT(batt_str, sizeof(batt_str), "%.2f", fmt_fix((int32_t)batt_level_f, 3));
+	MYLOG("APP", "Battery %s V", batt_str);
+	return batt_level_f;
+}
@@ -0,0 +1,249 @@
+/**
+ * @file i2c_bus.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Thread safe access to the I2C bus with per device clock
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * All tasks (app loop, GNSS, timers) share the same Wire instance.
+ * A transaction is wrapped in i2c_bus_take() / i2c_bus_give().
+ * The bus is locked with a recursive FreeRTOS mutex, which is a queue
+ * with priority inheritance, so waiting tasks are served in priority order.
+ * On take the clock of the device is set, on give the clock of the
+ * outer access (if nested) is restored.
+ * The nRF52 Wire implementation already uses the TWIM peripheral with
+ * EasyDMA for all transfers.
+ */
+#include "main.h"
+
+/** Bus access in progress */
+struct i2c_access_s
+{
+	i2c_device_s *device;
+	uint32_t clock;
+	uint32_t start_us;
+};
+
+/** Mutex for the bus */
+static SemaphoreHandle_t i2c_mutex = NULL;
+
+/** Devices with clock profile */
+static i2c_device_s i2c_devices[I2C_MAX_DEVICES];
+static uint8_t i2c_num_devices = 0;
+
+/** Nested accesses of the task that owns the bus */
+static i2c_access_s i2c_access[I2C_MAX_NESTING];
+static uint8_t i2c_depth = 0;
+/** Accesses that did not fit into i2c_access */
+static uint8_t i2c_overflow = 0;
+
+/** Time the bus was locked in us */
+static uint64_t i2c_busy_us = 0;
+/** Time of bus manager start */
+static time_t i2c_start_time = 0;
+
+/**
+ * @brief Create the bus mutex and add the known device profiles
+ *
+ */
+void i2c_bus_init(void)
+{
+	if (i2c_mutex != NULL)
+	{
+		return;
+	}
+	i2c_mutex = xSemaphoreCreateRecursiveMutex();
+	i2c_start_time = millis();
+
+	i2c_bus_add(0x3c, 400000, "RAK1921");
+	i2c_bus_add(0x42, 400000, "RAK12500");
+}
+
+/**
+ * @brief Add a clock profile for a device
+ *
+ * @param address I2C address
+ * @param clock I2C clock in Hz
+ * @param name name of the device
+ * @return true if profile was added or updated
+ * @return false if no space for more devices
+ */
+bool i2c_bus_add(uint8_t address, uint32_t clock, const char *name)
+{
+	i2c_device_s *device = i2c_bus_find(address);
+	if (device == NULL)
+	{
+		if (i2c_num_devices == I2C_MAX_DEVICES)
+		{
+			return false;
+		}
+		device = &i2c_devices[i2c_num_devices++];
+		device->address = address;
+		device->transactions = 0;
+		device->busy_us = 0;
+	}
+	device->clock = clock;
+	device->name = name;
+	return true;
+}
+
+/**
+ * @brief Find the profile of a device
+ *
+ * @param address I2C address
+ * @return i2c_device_s* profile or NULL if unknown
+ */
+i2c_device_s *i2c_bus_find(uint8_t address)
+{
+	for (uint8_t idx = 0; idx < i2c_num_devices; idx++)
+	{
+		if (i2c_devices[idx].address == address)
+		{
+			return &i2c_devices[idx];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Lock the bus and set the clock for a device
+ * 		Blocks until the bus is free. Can be nested by the same task.
+ *
+ * @param address I2C address or I2C_ALL_DEVICES
+ * @return true bus is locked
+ * @return false bus manager not initialized
+ */
+bool i2c_bus_take(uint8_t address)
+{
+	if (i2c_mutex == NULL)
+	{
+		i2c_bus_init();
+	}
+	if (xSemaphoreTakeRecursive(i2c_mutex, portMAX_DELAY) != pdTRUE)
+	{
+		return false;
+	}
+
+	i2c_device_s *device = address == I2C_ALL_DEVICES ? NULL : i2c_bus_find(address);
+	uint32_t clock = device != NULL ? device->clock : I2C_DEFAULT_CLOCK;
+
+	if (i2c_depth == I2C_MAX_NESTING)
+	{
+		i2c_overflow++;
+		return true;
+	}
+	i2c_access[i2c_depth].device = device;
+	i2c_access[i2c_depth].clock = clock;
+	i2c_access[i2c_depth].start_us = micros();
+	i2c_depth++;
+
+	Wire.setClock(clock);
+	return true;
+}
+
+/**
+ * @brief Release the bus
+ * 		Updates the statistics of the device and restores the clock of a nested access
+ *
+ */
+void i2c_bus_give(void)
+{
+	if (i2c_overflow != 0)
+	{
+		i2c_overflow--;
+		xSemaphoreGiveRecursive(i2c_mutex);
+		return;
+	}
+	if (i2c_depth == 0)
+	{
+		return;
+	}
+
+	i2c_depth--;
+	i2c_access_s *access = &i2c_access[i2c_depth];
+	uint32_t elapsed = micros() - access->start_us;
+	if (access->device != NULL)
+	{
+		access->device->transactions++;
+		access->device->busy_us += elapsed;
+	}
+	if (i2c_depth == 0)
+	{
+		i2c_busy_us += elapsed;
+	}
+	else if (i2c_access[i2c_depth - 1].clock != access->clock)
+	{
+		Wire.setClock(i2c_access[i2c_depth - 1].clock);
+	}
+	xSemaphoreGiveRecursive(i2c_mutex);
+}
+
+/**
+ * @brief Read a register block of an I2C device
+ *
+ * @param address I2C address
+ * @param reg register address
+ * @param data buffer for the register content
+ * @param len number of bytes to read
+ * @return true if the device ACKed and sent all bytes
+ * @return false if the read failed
+ */
+bool i2c_bus_read(uint8_t address, uint8_t reg, uint8_t *data, uint8_t len)
+{
+	Wire.beginTransmission(address);
+	Wire.write(reg);
+	if (Wire.endTransmission(false) != 0)
+	{
+		return false;
+	}
+	if (Wire.requestFrom(address, len) != len)
+	{
+		return false;
+	}
+	for (uint8_t idx = 0; idx < len; idx++)
+	{
+		data[idx] = Wire.read();
+	}
+	return true;
+}
+
+/**
+ * @brief Change the clock of the current bus access
+ * 		Used by tests that run the same device with different clocks.
+ * 		The clock of an outer access is restored by i2c_bus_give()
+ *
+ * @param clock I2C clock in Hz
+ */
+void i2c_bus_set_clock(uint32_t clock)
+{
+	if ((i2c_depth == 0) || (i2c_overflow != 0))
+	{
+		return;
+	}
+	i2c_access[i2c_depth - 1].clock = clock;
+	Wire.setClock(clock);
+}
+
+/**
+ * @brief Create a report of the bus usage
+ * 		Format: BUS=<utilization %>;<name>,<address>,<clock kHz>,<transactions>,<busy ms>;...
+ *
+ * @param buff buffer for the report
+ * @param buff_size size of the buffer
+ */
+void i2c_bus_report(char *buff, size_t buff_size)
+{
+	time_t run_time = millis() - i2c_start_time;
+	// Utilization in 1/100 %
+	uint32_t utilization = run_time != 0 ? (uint32_t)((i2c_busy_us * 10) / run_time) : 0;
+	size_t len = snprintf(buff, buff_size, "BUS=%lu.%02lu%%", utilization / 100, utilization % 100);
+
+	for (uint8_t idx = 0; (idx < i2c_num_devices) && (len < buff_size); idx++)
+	{
+		i2c_device_s *device = &i2c_devices[idx];
+		len += snprintf(&buff[len], buff_size - len, ";%s,0x%02X,%ldk,%ld,%ld", device->name, device->address,
+						device->clock / 1000, device->transactions, device->busy_us / 1000);
+	}
+}
@@ -0,0 +1,43 @@
+/**
+ * @file i2c_bus.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Thread safe access to the I2C bus with per device clock
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+#include <Arduino.h>
+
+/** Max number of devices with an own clock profile */
+#define I2C_MAX_DEVICES 16
+/** Clock for devices without profile, some modules support only 100kHz */
+#define I2C_DEFAULT_CLOCK 100000
+/** Max nesting of bus access (e.g. OLED output during I2C scan) */
+#define I2C_MAX_NESTING 4
+/** Pseudo address to lock the bus for a scan of all addresses */
+#define I2C_ALL_DEVICES 0x00
+
+/** Clock profile and statistics of a device */
+struct i2c_device_s
+{
+	uint8_t address;
+	uint32_t clock;
+	const char *name;
+	uint32_t transactions;
+	uint32_t busy_us;
+};
+
+void i2c_bus_init(void);
+bool i2c_bus_add(uint8_t address, uint32_t clock, const char *name);
+i2c_device_s *i2c_bus_find(uint8_t address);
+bool i2c_bus_take(uint8_t address);
+void i2c_bus_give(void);
+void i2c_bus_set_clock(uint32_t clock);
+bool i2c_bus_read(uint8_t address, uint8_t reg, uint8_t *data, uint8_t len);
+void i2c_bus_report(char *buff, size_t buff_size);
+
+#endif // I2C_BUS_H
@@ -0,0 +1,51 @@
+/**
+ * @file i2c_ident.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Identification of WisBlock I2C modules by address and ID register
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "main.h"
+#include "i2c_ident.h"
+
+/**
+ * @brief Get the name of the module on an address
+ * 		Candidates with ID register are checked with a single register read each,
+ * 		if none matches the first candidate without ID register is used.
+ *
+ * @param address I2C address
+ * @return const char* module name or NULL if unknown
+ */
+const char *i2c_identify(uint8_t address)
+{
+	int first = i2c_module_first(address);
+	if (first < 0)
+	{
+		return NULL;
+	}
+
+	const char *no_id = NULL;
+	uint8_t id;
+	i2c_bus_take(I2C_ALL_DEVICES);
+	for (size_t idx = first; (idx < I2C_NUM_MODULES) && (i2c_modules[idx].address == address); idx++)
+	{
+		if (i2c_modules[idx].mask == 0)
+		{
+			if (no_id == NULL)
+			{
+				no_id = i2c_modules[idx].name;
+			}
+			continue;
+		}
+		if (i2c_bus_read(address, i2c_modules[idx].reg, &id, 1) && ((id & i2c_modules[idx].mask) == i2c_modules[idx].value))
+		{
+			i2c_bus_give();
+			return i2c_modules[idx].name;
+		}
+	}
+	i2c_bus_give();
+	return no_id;
+}
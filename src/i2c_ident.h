@@ -0,0 +1,174 @@
+/**
+ * @file i2c_ident.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Identification of WisBlock I2C modules by address and ID register
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The module table and the hash table are built at compile time (C++11 constexpr).
+ * A lookup is one multiplication and one compare, followed by one register
+ * read per candidate on the same address.
+ */
+#ifndef I2C_IDENT_H
+#define I2C_IDENT_H
+#include <Arduino.h>
+
+/** Known module */
+struct i2c_module_s
+{
+	uint8_t address;
+	uint8_t reg;   // ID register
+	uint8_t mask;  // mask for the ID value, 0 if the module has no ID register
+	uint8_t value; // expected ID value
+	const char *name;
+};
+
+/**
+ * Known WisBlock modules, sorted by address.
+ * Modules with ID register first if several modules share an address.
+ */
+constexpr i2c_module_s i2c_modules[] = {
+	{0x10, 0x07, 0xff, 0x81, "RAK12010 VEML7700"},
+	{0x18, 0x0f, 0xff, 0x33, "RAK1904 LIS3DH"},
+	{0x19, 0x0f, 0xff, 0x33, "RAK1904 LIS3DH"},
+	{0x1d, 0x00, 0xff, 0xad, "RAK12032 ADXL313"},
+	{0x20, 0x00, 0x00, 0x00, "RAK13003 MCP23017"},
+	{0x29, 0xc0, 0xff, 0xee, "RAK12014 VL53L0X"},
+	{0x3a, 0x00, 0x00, 0x00, "RAK12003 MLX90632"},
+	{0x3c, 0x00, 0x00, 0x00, "RAK1921 SSD1306"},
+	{0x41, 0x00, 0x00, 0x00, "RAK16000 INA219"},
+	{0x42, 0x00, 0x00, 0x00, "RAK12500 u-blox"},
+	{0x44, 0x7f, 0xff, 0x30, "RAK1903 OPT3001"},
+	{0x48, 0x00, 0x00, 0x00, "ADS1115"},
+	{0x52, 0x00, 0x00, 0x00, "RAK12002 RV-3028"},
+	{0x53, 0x06, 0xff, 0xb2, "RAK12019 LTR390"},
+	{0x57, 0xff, 0xff, 0x15, "RAK12012 MAX30102"},
+	{0x59, 0x00, 0x00, 0x00, "RAK12047 SGP40"},
+	{0x5c, 0x0f, 0xff, 0xb1, "RAK1902 LPS22HB"},
+	{0x5d, 0x0f, 0xff, 0xb1, "RAK1902 LPS22HB"},
+	{0x61, 0x00, 0x00, 0x00, "RAK12037 SCD30"},
+	{0x68, 0x75, 0xff, 0x71, "RAK1905 MPU9250"},
+	{0x68, 0x0f, 0xff, 0xd3, "RAK12025 I3G4250D"},
+	{0x68, 0x00, 0x00, 0x00, "RAK12040 AMG8833"},
+	{0x70, 0x00, 0x00, 0x00, "RAK1901 SHTC3"},
+	{0x76, 0xd0, 0xff, 0x61, "RAK1906 BME680"},
+};
+
+/** Number of known modules */
+#define I2C_NUM_MODULES (sizeof(i2c_modules) / sizeof(i2c_modules[0]))
+/** Number of hash slots, power of 2 */
+#define I2C_HASH_SLOTS 64
+/** Empty hash slot */
+#define I2C_HASH_EMPTY 0xff
+
+/**
+ * @brief Hash of an I2C address
+ *
+ * @param address I2C address
+ * @param mult multiplier
+ * @return constexpr uint8_t slot
+ */
+constexpr uint8_t i2c_hash(uint8_t address, uint8_t mult)
+{
+	return (uint8_t)(address * mult) >> 2;
+}
+
+/**
+ * @brief Check if the address of table entry idx collides with any entry before it
+ *
+ * @return true if an entry with another address has the same hash
+ */
+constexpr bool i2c_hash_collides(uint8_t mult, size_t idx, size_t other)
+{
+	return other == idx ? false
+						: ((i2c_modules[other].address != i2c_modules[idx].address) &&
+						   (i2c_hash(i2c_modules[other].address, mult) == i2c_hash(i2c_modules[idx].address, mult))) ||
+							  i2c_hash_collides(mult, idx, other + 1);
+}
+
+/**
+ * @brief Check if a multiplier maps all addresses to different slots
+ */
+constexpr bool i2c_hash_perfect(uint8_t mult, size_t idx)
+{
+	return idx == I2C_NUM_MODULES ? true : !i2c_hash_collides(mult, idx, 0) && i2c_hash_perfect(mult, idx + 1);
+}
+
+/**
+ * @brief Find the first odd multiplier without collisions
+ *
+ * @return constexpr uint8_t multiplier or 0 if none was found
+ */
+constexpr uint8_t i2c_hash_find(unsigned mult)
+{
+	return mult > 255 ? 0 : i2c_hash_perfect((uint8_t)mult, 0) ? (uint8_t)mult
+															   : i2c_hash_find(mult + 2);
+}
+
+/** Multiplier of the perfect hash */
+constexpr uint8_t I2C_HASH_MULT = i2c_hash_find(1);
+static_assert(I2C_HASH_MULT != 0, "No perfect hash for the I2C module table, increase I2C_HASH_SLOTS");
+
+/**
+ * @brief Find the first table entry for a hash slot
+ *
+ * @return constexpr uint8_t table index or I2C_HASH_EMPTY
+ */
+constexpr uint8_t i2c_slot_entry(size_t slot, size_t idx)
+{
+	return idx == I2C_NUM_MODULES ? I2C_HASH_EMPTY
+								  : i2c_hash(i2c_modules[idx].address, I2C_HASH_MULT) == slot ? (uint8_t)idx
+																							   : i2c_slot_entry(slot, idx + 1);
+}
+
+/** Hash slots, index of the first module with the address */
+struct i2c_hash_table_s
+{
+	uint8_t entry[I2C_HASH_SLOTS];
+};
+
+/** C++11 replacement for std::index_sequence */
+template <size_t... S>
+struct i2c_seq
+{
+};
+template <size_t N, size_t... S>
+struct i2c_make_seq : i2c_make_seq<N - 1, N - 1, S...>
+{
+};
+template <size_t... S>
+struct i2c_make_seq<0, S...>
+{
+	typedef i2c_seq<S...> type;
+};
+
+template <size_t... S>
+constexpr i2c_hash_table_s i2c_build_hash(i2c_seq<S...>)
+{
+	return i2c_hash_table_s{{i2c_slot_entry(S, 0)...}};
+}
+
+/** The hash table */
+constexpr i2c_hash_table_s i2c_hash_table = i2c_build_hash(i2c_make_seq<I2C_HASH_SLOTS>::type());
+
+/**
+ * @brief Get the first known module with an address
+ *
+ * @param address I2C address
+ * @return int index into i2c_modules or -1 if the address is unknown
+ */
+inline int i2c_module_first(uint8_t address)
+{
+	uint8_t idx = i2c_hash_table.entry[i2c_hash(address, I2C_HASH_MULT)];
+	if ((idx == I2C_HASH_EMPTY) || (i2c_modules[idx].address != address))
+	{
+		return -1;
+	}
+	return idx;
+}
+
+const char *i2c_identify(uint8_t address);
+
+#endif // I2C_IDENT_H
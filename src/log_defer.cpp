@@ -0,0 +1,212 @@
+/**
+ * @file log_defer.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Deferred binary logger, ring buffers and flush task
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "main.h"
+
+#if MY_DEBUG > 0 && LOG_DEFERRED > 0
+
+/** Interval in ms for the flush task to check the ring buffers */
+#define LOG_FLUSH_INTERVAL 20
+
+/** Single producer / single consumer ring buffer */
+struct log_ring_s
+{
+	/** Task that writes into this ring, NULL if unused */
+	TaskHandle_t owner;
+	/** Write index, only changed by the producer */
+	volatile uint32_t head;
+	/** Read index, only changed by the flush task */
+	volatile uint32_t tail;
+	/** Number of frames that did not fit into the ring */
+	volatile uint32_t dropped;
+	uint8_t data[LOG_RING_SIZE];
+};
+
+/** Ring buffers, the last one is shared */
+static log_ring_s log_rings[LOG_NUM_RINGS];
+
+/** Handle of the flush task */
+TaskHandle_t log_task_handle = NULL;
+
+/**
+ * @brief Find the ring buffer of the calling task
+ * 		If the task has no ring yet, a free one is assigned.
+ * 		If all rings are taken, the shared ring is returned.
+ *
+ * @return log_ring_s* ring buffer to use
+ */
+static log_ring_s *log_get_ring(void)
+{
+	TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+	for (int idx = 0; idx < LOG_NUM_RINGS - 1; idx++)
+	{
+		if (log_rings[idx].owner == self)
+		{
+			return &log_rings[idx];
+		}
+	}
+
+	log_ring_s *ring = &log_rings[LOG_NUM_RINGS - 1];
+	taskENTER_CRITICAL();
+	for (int idx = 0; idx < LOG_NUM_RINGS - 1; idx++)
+	{
+		if (log_rings[idx].owner == NULL)
+		{
+			log_rings[idx].owner = self;
+			ring = &log_rings[idx];
+			break;
+		}
+	}
+	taskEXIT_CRITICAL();
+	return ring;
+}
+
+/**
+ * @brief Write a complete frame into a ring buffer
+ * 		The frame is published only after all bytes are written,
+ * 		so the flush task never sees a partial frame.
+ *
+ * @param ring ring buffer
+ * @param frame frame data
+ * @param frame_len frame length
+ */
+static void log_ring_write(log_ring_s *ring, uint8_t *frame, uint16_t frame_len)
+{
+	uint32_t head = ring->head;
+	if ((LOG_RING_SIZE - (head - ring->tail)) < frame_len)
+	{
+		ring->dropped++;
+		return;
+	}
+	for (uint16_t idx = 0; idx < frame_len; idx++)
+	{
+		ring->data[(head + idx) & (LOG_RING_SIZE - 1)] = frame[idx];
+	}
+	__DMB();
+	ring->head = head + frame_len;
+}
+
+/**
+ * @brief Build a frame and write it into the ring buffer of the calling task
+ *
+ * @param tag Tag of the message (address is sent)
+ * @param fmt Format string (address is sent)
+ * @param pack Packed arguments
+ */
+void log_defer_commit(const char *tag, const char *fmt, log_pack_s &pack)
+{
+	uint8_t frame[LOG_HEADER_SIZE + LOG_MAX_ARGS + 1];
+	uint16_t frame_len = LOG_HEADER_SIZE + pack.len + 1;
+	uint32_t value = millis();
+
+	frame[0] = LOG_SYNC;
+	frame[1] = pack.len | (pack.truncated ? LOG_TRUNCATED : 0);
+	memcpy(&frame[2], &value, 4);
+	value = (uint32_t)fmt;
+	memcpy(&frame[6], &value, 4);
+	value = (uint32_t)tag;
+	memcpy(&frame[10], &value, 4);
+	memcpy(&frame[LOG_HEADER_SIZE], pack.args, pack.len);
+
+	uint8_t checksum = 0;
+	for (uint16_t idx = 1; idx < frame_len - 1; idx++)
+	{
+		checksum ^= frame[idx];
+	}
+	frame[frame_len - 1] = checksum;
+
+	log_ring_s *ring = log_get_ring();
+	if (ring == &log_rings[LOG_NUM_RINGS - 1])
+	{
+		// Shared ring, multiple producers
+		taskENTER_CRITICAL();
+		log_ring_write(ring, frame, frame_len);
+		taskEXIT_CRITICAL();
+	}
+	else
+	{
+		log_ring_write(ring, frame, frame_len);
+	}
+}
+
+/**
+ * @brief Get number of frames that were dropped because a ring was full
+ *
+ * @return uint32_t number of dropped frames
+ */
+uint32_t log_defer_dropped(void)
+{
+	uint32_t dropped = 0;
+	for (int idx = 0; idx < LOG_NUM_RINGS; idx++)
+	{
+		dropped += log_rings[idx].dropped;
+	}
+	return dropped;
+}
+
+/**
+ * @brief Task that ships the ring buffer content to USB and BLE
+ *
+ * @param pvParameters unused
+ */
+void log_flush_task(void *pvParameters)
+{
+	uint8_t chunk[64];
+
+	while (true)
+	{
+#if FAST_BOOT > 0
+		// Keep the frames in the rings until there is someone to receive them
+		if (!Serial && !g_ble_uart_is_connected)
+		{
+			vTaskDelay(LOG_FLUSH_INTERVAL);
+			continue;
+		}
+#endif
+		for (int idx = 0; idx < LOG_NUM_RINGS; idx++)
+		{
+			log_ring_s *ring = &log_rings[idx];
+			uint32_t available;
+			while ((available = ring->head - ring->tail) > 0)
+			{
+				uint32_t tail = ring->tail;
+				uint16_t chunk_len = available > sizeof(chunk) ? sizeof(chunk) : available;
+				for (uint16_t pos = 0; pos < chunk_len; pos++)
+				{
+					chunk[pos] = ring->data[(tail + pos) & (LOG_RING_SIZE - 1)];
+				}
+				ring->tail = tail + chunk_len;
+
+				Serial.write(chunk, chunk_len);
+				if (g_ble_uart_is_connected)
+				{
+					g_ble_uart.write(chunk, chunk_len);
+				}
+			}
+		}
+		vTaskDelay(LOG_FLUSH_INTERVAL);
+	}
+}
+
+/**
+ * @brief Start the flush task of the deferred logger
+ *
+ */
+void log_defer_init(void)
+{
+	if (log_task_handle != NULL)
+	{
+		return;
+	}
+	xTaskCreate(log_flush_task, "LOG", 512, NULL, TASK_PRIO_LOWEST, &log_task_handle);
+}
+
+#endif
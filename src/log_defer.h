@@ -0,0 +1,172 @@
+/**
+ * @file log_defer.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Deferred binary logger, replaces printf formatting in MYLOG
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Instead of formatting the text on the calling task, only the address
+ * of the format string, the address of the tag and the raw arguments
+ * are written into a per-task ring buffer. A low priority task ships
+ * the frames to USB and BLE. The text is rebuilt on the host with
+ * tools/log_decode.py and the ELF file of the build.
+ *
+ * Frame layout (little endian):
+ * | 0xA5 | len | timestamp ms (4) | format addr (4) | tag addr (4) | args (len) | XOR checksum |
+ * Bit 7 of len is set if the arguments did not fit, all arguments after
+ * the first one that did not fit are left out.
+ *
+ * Argument encoding:
+ * - integers up to 32 bit, bool, enums, pointers: 4 bytes
+ * - 64 bit integers: 8 bytes
+ * - float and double: 4 byte float
+ * - strings: 1 byte length + characters (copied, no 0 terminator)
+ */
+#ifndef LOG_DEFER_H
+#define LOG_DEFER_H
+#include <Arduino.h>
+#include <type_traits>
+
+/** Frame start marker */
+#define LOG_SYNC 0xA5
+/** Size of the frame header (sync, len, timestamp, format, tag) */
+#define LOG_HEADER_SIZE 14
+/** Max size of the arguments of one log entry */
+#define LOG_MAX_ARGS 64
+/** Flag in the len byte of a frame with left out arguments */
+#define LOG_TRUNCATED 0x80
+/** Max length of a copied string argument */
+#define LOG_MAX_STR 48
+
+/** Size of a single ring buffer, must be a power of 2 */
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE 512
+#endif
+/** Number of ring buffers, the last one is shared by all tasks that did not get an own ring */
+#ifndef LOG_NUM_RINGS
+#define LOG_NUM_RINGS 4
+#endif
+
+static_assert(LOG_MAX_ARGS < LOG_TRUNCATED, "The args length must leave bit 7 of the len byte free");
+
+/** Argument packer for a single log entry */
+struct log_pack_s
+{
+	uint8_t args[LOG_MAX_ARGS];
+	uint8_t len = 0;
+	/** Set when an argument did not fit, no further arguments are packed */
+	bool truncated = false;
+
+	void put32(uint32_t value)
+	{
+		if (truncated || (len + 4 > LOG_MAX_ARGS))
+		{
+			truncated = true;
+			return;
+		}
+		memcpy(&args[len], &value, 4);
+		len += 4;
+	}
+
+	void put64(uint64_t value)
+	{
+		if (truncated || (len + 8 > LOG_MAX_ARGS))
+		{
+			truncated = true;
+			return;
+		}
+		memcpy(&args[len], &value, 8);
+		len += 8;
+	}
+
+	void put_str(const char *str)
+	{
+		if (str == NULL)
+		{
+			str = "(null)";
+		}
+		if (truncated || (len + 1 > LOG_MAX_ARGS))
+		{
+			truncated = true;
+			return;
+		}
+		size_t str_len = strnlen(str, LOG_MAX_STR);
+		if (len + 1 + str_len > LOG_MAX_ARGS)
+		{
+			// Truncate the string to the remaining space, the arguments after it are left out
+			str_len = LOG_MAX_ARGS - len - 1;
+			truncated = true;
+		}
+		args[len++] = (uint8_t)str_len;
+		memcpy(&args[len], str, str_len);
+		len += str_len;
+	}
+};
+
+template <typename T>
+inline typename std::enable_if<(std::is_integral<T>::value || std::is_enum<T>::value) && (sizeof(T) <= 4)>::type
+log_put(log_pack_s &pack, T value)
+{
+	pack.put32((uint32_t)value);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && (sizeof(T) == 8)>::type
+log_put(log_pack_s &pack, T value)
+{
+	pack.put64((uint64_t)value);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type
+log_put(log_pack_s &pack, T value)
+{
+	float value_f = (float)value;
+	uint32_t raw;
+	memcpy(&raw, &value_f, 4);
+	pack.put32(raw);
+}
+
+inline void log_put(log_pack_s &pack, const char *value)
+{
+	pack.put_str(value);
+}
+
+inline void log_put(log_pack_s &pack, const void *value)
+{
+	pack.put32((uint32_t)value);
+}
+
+inline void log_put_args(log_pack_s &pack)
+{
+}
+
+template <typename T, typename... Args>
+inline void log_put_args(log_pack_s &pack, T value, Args... args)
+{
+	log_put(pack, value);
+	log_put_args(pack, args...);
+}
+
+void log_defer_init(void);
+void log_defer_commit(const char *tag, const char *fmt, log_pack_s &pack);
+uint32_t log_defer_dropped(void);
+
+/**
+ * @brief Write a log entry without formatting it
+ *
+ * @param tag Tag of the message, should be a string literal or NULL
+ * @param fmt printf style format string, must be a string literal
+ * @param args Arguments for the format string
+ */
+template <typename... Args>
+inline void log_defer(const char *tag, const char *fmt, Args... args)
+{
+	log_pack_s pack;
+	log_put_args(pack, args...);
+	log_defer_commit(tag, fmt, pack);
+}
+
+#endif // LOG_DEFER_H
@@ -9,7 +9,7 @@
  *
  */
 #include "main.h"
-#include <radio/radio.h>
+#include "ble_bench.h"
 
 /** Send Fail counter **/
 uint8_t send_fail = 0;
@@ -24,18 +24,26 @@ bool has_rak1921 = false;
 bool has_rak12500 = false;
 
 /** Buffer for RAK1921 OLED text */
-char disp_txt[256];
+char disp_txt[DISP_TXT_SIZE];
 
 /** Flag if RAK14000 was found */
 bool has_rak14000 = false;
 
-/** Flag is LoRa init was successfull */
-uint8_t lora_success = 2;
+SoftwareTimer blink_leds_timer;
 
-/** Flag is Flash read/write was successfull */
-bool flash_success = false;
+/** Size of the buffer for AT commands received over BLE */
+#define BLE_CMD_BUFF_SIZE 256
+/** Time to wait for the rest of a command that was sent without line end */
+#define BLE_CMD_TIMEOUT 50
 
-SoftwareTimer blink_leds_timer;
+/** Buffer for AT commands received over BLE */
+char ble_cmd_buff[BLE_CMD_BUFF_SIZE];
+/** Number of bytes in the BLE command buffer */
+uint16_t ble_cmd_len = 0;
+/** Number of AT commands received over BLE */
+uint32_t ble_cmd_count = 0;
+/** Accumulated time in ms spent for BLE AT commands */
+uint32_t ble_cmd_time = 0;
 
 void toggle_led(TimerHandle_t unsused)
 {
@@ -49,6 +57,19 @@ void toggle_led(TimerHandle_t unsused)
  */
 void setup_app(void)
 {
+#if MY_DEBUG > 0 && LOG_DEFERRED == 0
+	// Keep the log output until USB or BLE is connected
+	boot_log_init();
+#endif
+
+#if MY_DEBUG > 0 && LOG_DEFERRED > 0
+	// Start the task that sends the deferred log entries
+	log_defer_init();
+#endif
+
+	// Shared I2C bus for OLED, GNSS and scan
+	i2c_bus_init();
+
 	// Set firmware version
 	api_set_version(SW_VERSION_1, SW_VERSION_2, SW_VERSION_3);
 
@@ -77,7 +98,9 @@ void setup_app(void)
  */
 bool init_app(void)
 {
+	TRACE_BEGIN("serial_wait");
 	Serial.begin(115200);
+#if FAST_BOOT == 0
 	time_t serial_timeout = millis();
 	// On nRF52840 the USB serial is not available immediately
 	while (!Serial)
@@ -93,6 +116,8 @@ bool init_app(void)
 		}
 	}
 	digitalWrite(LED_GREEN, LOW);
+#endif
+	TRACE_END("serial_wait");
 
 	MYLOG("APP", "Initialize application");
 	pinMode(WB_IO2, OUTPUT);
@@ -108,413 +133,398 @@ bool init_app(void)
 	blink_leds_timer.begin(250, toggle_led, NULL, true);
 	blink_leds_timer.start();
 
-	// Test OLED
-	has_rak1921 = init_rak1921();
-	if (has_rak1921)
-	{
-		rak1921_write_header((char *)"WisBlock Node");
-	}
-	else
-	{
-		MYLOG("OLED", "No OLED found");
-	}
+	// Time from reset to the first test, millis() starts with the RTC at reset
+	boot_first_test_ms = millis();
+	TRACE_MARK("first_test", boot_first_test_ms);
 
-	// Initialize EPD
-	has_rak14000 = init_rak14000();
-	if (has_rak1921)
-	{
-		if (has_rak14000)
-		{
-			sprintf(disp_txt, "Found RAK14000 EPD");
-			rak1921_add_line(disp_txt);
-		}
-		else
-		{
-			sprintf(disp_txt, "No RAK14000 EPD");
-			rak1921_add_line(disp_txt);
-		}
-	}
+	// Run the enabled tests of the test plan (OLED, EPD, I2C scan and margin, GNSS, flash, SPI flash, SX126x, battery)
+	test_plan_boot();
 
-	if (has_rak14000)
-	{
-		MYLOG("EPD", "Found RAK14000 EPD");
-	}
-	else
-	{
-		MYLOG("EPD", "No RAK14000 EPD");
-	}
+	// Open the soak log after the flash test
+	soak_init();
 
-	// Scan the I2C interfaces for devices
-	byte error;
-	uint8_t num_dev = 0;
+	// Show the results on OLED and EPD
+	result_publish();
+	blink_leds_timer.start();
 
-	Wire.begin();
-	// Some modules support only 100kHz
-	Wire.setClock(100000);
-	for (byte address = 1; address < 127; address++)
-	{
-		Wire.beginTransmission(address);
-		error = Wire.endTransmission();
-		if (error == 0)
-		{
-			MYLOG("SCAN", "Found sensor at I2C1 0x%02X", address);
-			if (address == 0x3c)
-			{
-				has_rak1921 = true;
-			}
-			if (has_rak1921)
-			{
-				sprintf(disp_txt, "Found I2C device 0x%02X", address);
-				rak1921_add_line(disp_txt);
-			}
-			if (address == 0x42)
-			{
-				has_rak12500 = true;
-			}
-			num_dev++;
-		}
-	}
-	MYLOG("SCAN", "Found %d I2C devices", num_dev);
-	if (has_rak1921)
-	{
-		sprintf(disp_txt, "Found %d I2C devices", num_dev);
-		rak1921_add_line(disp_txt);
-	}
+#if HW_BENCHMARK > 0
+	// Measure the driver primitives
+	run_benchmarks();
+#endif
 
-	// If it has RAK12500, setup the GNSS module with RAK specific settings
-	if (has_rak12500)
-	{
-		has_rak12500 = init_gnss();
-	}
+	// restart_advertising(60);
 
-	// Erase flash file system
-	flash_reset();
-	// Save LoRaWAN settings (in case they were still there on top of Meshtastic settings)
-	api_set_credentials();
+	Serial.flush();
+	delay(500);
+
+#if APP_TRACE > 0
+	// Boot tests are finished, send the timeline
+	TRACE_MARK("test_done", 0);
+	trace_dump();
+#endif
+
+	// Display buffers are claimed now, log the RAM usage
+	ram_report_log();
 
-	// Write-Read Flash test
-	MYLOG("FLASH", "Flash Write-Read test #1");
+	// Boot tests are finished
+	POWER_STAGE(POWER_STAGE_WAIT);
+
+	return true;
+}
 
-	if (save_settings())
+/**
+ * @brief Timer triggered event, test cycle
+ *
+ */
+static void status_event(void)
+{
+	TRACE_SCOPE("status_cycle");
+	// restart_advertising(60);
+	MYLOG("APP", "Timer wakeup");
+	if (has_rak1921)
 	{
-		flash_success = true;
-		MYLOG("FLASH", "Flash Write-Read test #1 success");
-		if (has_rak1921)
-		{
-			sprintf(disp_txt, "Flash Write-Read test #1 success");
-			rak1921_add_line(disp_txt);
-		}
+		sprintf(disp_txt, "Timer wakeup");
+		rak1921_add_line(disp_txt);
 	}
-	else
+
+	// Check GNSS location
+	if (has_rak12500)
 	{
-		flash_success = false;
-		MYLOG("FLASH", "Flash Write-Read test #1 failed");
+		MYLOG("APP", "Try GNSS");
 		if (has_rak1921)
 		{
-			sprintf(disp_txt, "Flash Write-Read test #1 failed");
+			sprintf(disp_txt, "Try GNSS");
 			rak1921_add_line(disp_txt);
 		}
+		POWER_STAGE(POWER_STAGE_GNSS);
+		poll_gnss();
+		POWER_STAGE(POWER_STAGE_CYCLE);
 	}
-	MYLOG("FLASH", "Read send time from flash %ld", g_lorawan_settings.send_repeat_time);
 
-	MYLOG("FLASH", "Flash Write-Read test #2");
-	g_lorawan_settings.send_repeat_time = 60000;
+	// Restart BLE advertising
+	// restart_advertising(30);
 
-	if (save_settings())
-	{
-		flash_success = true;
-		MYLOG("FLASH", "Flash Write-Read test #2 success");
-		if (has_rak1921)
-		{
-			sprintf(disp_txt, "Flash Write-Read test #2 success");
-			rak1921_add_line(disp_txt);
-		}
-	}
-	else
+	// Get Battery status
+	float batt_level_f = 0.0;
+	for (int readings = 0; readings < 10; readings++)
 	{
-		flash_success = false;
-		MYLOG("FLASH", "Flash Write-Read test #2 failed");
-		if (has_rak1921)
-		{
-			sprintf(disp_txt, "Flash Write-Read test #2 failed");
-			rak1921_add_line(disp_txt);
-		}
+		batt_level_f += read_batt();
 	}
+	batt_level_f = batt_level_f / 10;
+	result_set(RESULT_BATT, (int32_t)batt_level_f);
+	char batt_str[12];
+	FMT(batt_str, sizeof(batt_str), "%.2f", fmt_fix((int32_t)batt_level_f, 3));
+	MYLOG("APP", "Battery %s V", batt_str);
 
-	// Check connection to SX126x
-	// After power on the sync word should be 2414. 4434 could be possible on a restart (private network syncword)
-	// If we got something else, something is wrong.
-	uint16_t readSyncWord = 0;
+	// Battery, RSSI and GNSS trend for soak tests
+	soak_sample();
 
-	SX126xReadRegisters(REG_LR_SYNCWORD, (uint8_t *)&readSyncWord, 2);
+	// Dummy packet
+	uint8_t dummy_packet[] = {0x01, 0x74, 0x00, 0x55};
+	uint16_t batt_level = (uint16_t)(batt_level_f);
+	dummy_packet[2] = (uint8_t)(batt_level >> 8);
+	dummy_packet[3] = (uint8_t)(batt_level);
 
-	MYLOG("SX1262", "SyncWord = %04X", readSyncWord);
-	if (has_rak1921)
+	if (g_lorawan_settings.lorawan_enable)
 	{
-		sprintf(disp_txt, "SyncWord = %04X", readSyncWord);
-		rak1921_add_line(disp_txt);
-	}
+		if (g_lpwan_has_joined)
+		{
 
-	if ((readSyncWord == 0x2414) || (readSyncWord == 0x4434))
-	{
-		MYLOG("SX1262", "LoRa transceiver ok");
-		if (has_rak1921)
+			lmh_error_status result = send_lora_packet(dummy_packet, 4, 2);
+			switch (result)
+			{
+			case LMH_SUCCESS:
+				MYLOG("APP", "Packet enqueued");
+				result_set(RESULT_TX, 0);
+				break;
+			case LMH_BUSY:
+				MYLOG("APP", "LoRa transceiver is busy");
+				result_set(RESULT_TX, 1);
+				break;
+			case LMH_ERROR:
+				MYLOG("APP", "Packet error, too big to send with current DR");
+				result_set(RESULT_TX, 1);
+				break;
+			}
+		}
+		else
 		{
-			sprintf(disp_txt, "LoRa transceiver ok");
-			rak1921_add_line(disp_txt);
+			MYLOG("APP", "Network not joined, skip sending");
 		}
 	}
 	else
 	{
-		MYLOG("SX1262", "SyncWord is incorrect, potential problem in SPI setup or LoRa transceiver");
+		MYLOG("APP", "Send P2P packet");
 		if (has_rak1921)
 		{
-			sprintf(disp_txt, "SX1262 problem (SPI or LoRa chip");
+			sprintf(disp_txt, "Send P2P packet");
 			rak1921_add_line(disp_txt);
 		}
+		result_set(RESULT_TX, send_p2p_packet(dummy_packet, 4) ? 0 : 1);
 	}
 
-	// Read battery values
-	float batt_level_f = 0.0;
-	for (int readings = 0; readings < 10; readings++)
+	result_publish();
+}
+
+/**
+ * @brief Forward a complete command from the BLE buffer to the AT command interpreter
+ *
+ */
+void ble_dispatch_cmd(void)
+{
+	if (ble_cmd_len >= BLE_CMD_BUFF_SIZE)
 	{
-		batt_level_f += read_batt();
+		MYLOG("AT", "BLE command too long, discarded");
+		ble_cmd_len = 0;
+		return;
 	}
-	batt_level_f = batt_level_f / 10;
-	MYLOG("APP", "Battery %.2f V", batt_level_f / 1000);
+	ble_cmd_buff[ble_cmd_len] = 0;
 
-	if (has_rak14000)
+	// BLE throughput test commands are handled here, not by the AT command interpreter
+	if (ble_bench_command(ble_cmd_buff))
 	{
-		refresh_rak14000();
+		ble_cmd_len = 0;
+		return;
 	}
-	blink_leds_timer.start();
-
-	// restart_advertising(60);
 
-	Serial.flush();
-	delay(500);
-
-	return true;
+	for (uint16_t idx = 0; idx < ble_cmd_len; idx++)
+	{
+		at_serial_input(uint8_t(ble_cmd_buff[idx]));
+	}
+	at_serial_input(uint8_t('\n'));
+	ble_cmd_len = 0;
 }
 
 /**
- * @brief Handle events
- * 		Events can be
- * 		- timer (setup with AT+SENDINT=xxx)
- * 		- interrupt events
- * 		- wake-up signals from other tasks
+ * @brief BLE UART data arrived
+ *
  */
-void app_event_handler(void)
+static void ble_rx_event(void)
 {
-	blink_leds_timer.start();
-	// Timer triggered event
-	if ((g_task_event_type & STATUS) == STATUS)
+	if (!g_enable_ble)
 	{
-		g_task_event_type &= N_STATUS;
-		// restart_advertising(60);
-		MYLOG("APP", "Timer wakeup");
-		if (has_rak1921)
-		{
-			sprintf(disp_txt, "Timer wakeup");
-			rak1921_add_line(disp_txt);
-		}
-
-		// Check GNSS location
-		if (has_rak12500)
+		return;
+	}
+	/**************************************************************/
+	/**************************************************************/
+	/// \todo BLE UART data arrived
+	/// \todo or forward them to the AT command interpreter
+	/// \todo parse them here
+	/**************************************************************/
+	/**************************************************************/
+	MYLOG("AT", "RECEIVED BLE");
+	// BLE UART data arrived
+	// in this example we forward it to the AT command interpreter
+
+	time_t batch_start = millis();
+	uint16_t batch_cmds = 0;
+	uint8_t rx_buff[64];
+	int rx_len;
+
+	while (true)
+	{
+		// Drain the BLE UART in chunks and split into commands
+		while ((rx_len = g_ble_uart.read(rx_buff, sizeof(rx_buff))) > 0)
 		{
-			MYLOG("APP", "Try GNSS");
-			if (has_rak1921)
+			for (int idx = 0; idx < rx_len; idx++)
 			{
-				sprintf(disp_txt, "Try GNSS");
-				rak1921_add_line(disp_txt);
+				if ((rx_buff[idx] == '\r') || (rx_buff[idx] == '\n'))
+				{
+					if (ble_cmd_len != 0)
+					{
+						ble_dispatch_cmd();
+						batch_cmds++;
+					}
+				}
+				else if (ble_cmd_len < BLE_CMD_BUFF_SIZE)
+				{
+					ble_cmd_buff[ble_cmd_len++] = rx_buff[idx];
+				}
 			}
-			poll_gnss();
 		}
 
-		// Restart BLE advertising
-		// restart_advertising(30);
-
-		// Get Battery status
-		float batt_level_f = 0.0;
-		for (int readings = 0; readings < 10; readings++)
+		if (ble_cmd_len == 0)
 		{
-			batt_level_f += read_batt();
+			break;
 		}
-		batt_level_f = batt_level_f / 10;
-		MYLOG("APP", "Battery %.2f V", batt_level_f / 1000);
-
-		// Dummy packet
-		uint8_t dummy_packet[] = {0x01, 0x74, 0x00, 0x55};
-		uint16_t batt_level = (uint16_t)(batt_level_f);
-		dummy_packet[2] = (uint8_t)(batt_level >> 8);
-		dummy_packet[3] = (uint8_t)(batt_level);
 
-		if (g_lorawan_settings.lorawan_enable)
+		// Command without line end, wait a short time for the next BLE packet
+		time_t wait_start = millis();
+		while ((g_ble_uart.available() == 0) && ((millis() - wait_start) < BLE_CMD_TIMEOUT))
 		{
-			if (g_lpwan_has_joined)
-			{
-
-				lmh_error_status result = send_lora_packet(dummy_packet, 4, 2);
-				switch (result)
-				{
-				case LMH_SUCCESS:
-					MYLOG("APP", "Packet enqueued");
-					lora_success = 0;
-					break;
-				case LMH_BUSY:
-					MYLOG("APP", "LoRa transceiver is busy");
-					lora_success = 1;
-					break;
-				case LMH_ERROR:
-					MYLOG("APP", "Packet error, too big to send with current DR");
-					lora_success = 1;
-					break;
-				}
-			}
-			else
-			{
-				MYLOG("APP", "Network not joined, skip sending");
-			}
+			delay(1);
 		}
-		else
+		if (g_ble_uart.available() == 0)
 		{
-			MYLOG("APP", "Send P2P packet");
-			if (has_rak1921)
-			{
-				sprintf(disp_txt, "Send P2P packet");
-				rak1921_add_line(disp_txt);
-			}
-			if (send_p2p_packet(dummy_packet, 4))
-			{
-				lora_success = 0;
-			}
-			else
-			{
-				lora_success = 1;
-			}
+			// Nothing more, the command is complete
+			ble_dispatch_cmd();
+			batch_cmds++;
+			break;
 		}
+	}
 
-		if (has_rak14000)
-		{
-			refresh_rak14000();
-			delay(3000);
-		}
+	if (batch_cmds != 0)
+	{
+		uint32_t batch_time = millis() - batch_start;
+		ble_cmd_count += batch_cmds;
+		ble_cmd_time += batch_time;
+		MYLOG("AT", "BLE %d commands in %ld ms, total %ld commands, %ld cmds/s", batch_cmds, batch_time,
+			  ble_cmd_count, ble_cmd_time != 0 ? (ble_cmd_count * 1000) / ble_cmd_time : 0);
 	}
 }
 
 /**
- * @brief Handle BLE events
+ * @brief LoRa Join finished
  *
  */
-void ble_data_handler(void)
+static void join_fin_event(void)
 {
-	if (g_enable_ble)
+	if (g_join_result)
 	{
-		/**************************************************************/
-		/**************************************************************/
-		/// \todo BLE UART data arrived
-		/// \todo or forward them to the AT command interpreter
-		/// \todo parse them here
-		/**************************************************************/
-		/**************************************************************/
-		if ((g_task_event_type & BLE_DATA) == BLE_DATA)
-		{
-			MYLOG("AT", "RECEIVED BLE");
-			// BLE UART data arrived
-			// in this example we forward it to the AT command interpreter
-			g_task_event_type &= N_BLE_DATA;
+		MYLOG("APP", "Successfully joined network");
+	}
+	else
+	{
+		MYLOG("APP", "Join network failed");
+		/// \todo here join could be restarted.
+		// lmh_join();
+	}
+}
 
-			while (g_ble_uart.available() > 0)
-			{
-				at_serial_input(uint8_t(g_ble_uart.read()));
-				delay(5);
-			}
-			at_serial_input(uint8_t('\n'));
-		}
+/**
+ * @brief LoRa data arrived
+ *
+ */
+static void lora_rx_event(void)
+{
+	/**************************************************************/
+	/**************************************************************/
+	/// \todo LoRa data arrived
+	/// \todo parse them here
+	/**************************************************************/
+	/**************************************************************/
+	MYLOG("APP", "Received package over LoRa");
+	MYLOG("APP", "Last RSSI %d", g_last_rssi);
+
+	char log_buff[g_rx_data_len * 3] = {0};
+	uint8_t log_idx = 0;
+	for (int idx = 0; idx < g_rx_data_len; idx++)
+	{
+		sprintf(&log_buff[log_idx], "%02X ", g_rx_lora_data[idx]);
+		log_idx += 3;
 	}
+	MYLOG("APP", "%s", log_buff);
 }
 
 /**
- * @brief Handle LoRa events
+ * @brief LoRa TX finished
  *
  */
-void lora_data_handler(void)
+static void tx_fin_event(void)
 {
-	// LoRa Join finished handling
-	if ((g_task_event_type & LORA_JOIN_FIN) == LORA_JOIN_FIN)
+	if (g_lorawan_settings.lorawan_enable)
 	{
-		g_task_event_type &= N_LORA_JOIN_FIN;
-		if (g_join_result)
+		if (g_lorawan_settings.confirmed_msg_enabled == LMH_UNCONFIRMED_MSG)
 		{
-			MYLOG("APP", "Successfully joined network");
+			MYLOG("APP", "LPWAN TX cycle finished");
 		}
 		else
 		{
-			MYLOG("APP", "Join network failed");
-			/// \todo here join could be restarted.
-			// lmh_join();
+			MYLOG("APP", "LPWAN TX cycle %s", g_rx_fin_result ? "finished ACK" : "failed NAK");
 		}
-	}
+		if (!g_rx_fin_result)
+		{
+			// Increase fail send counter
+			send_fail++;
 
-	// LoRa data handling
-	if ((g_task_event_type & LORA_DATA) == LORA_DATA)
+			if (send_fail == 10)
+			{
+				// Too many failed sendings, reset node and try to rejoin
+				delay(100);
+				api_reset();
+			}
+		}
+	}
+	else
 	{
-		/**************************************************************/
-		/**************************************************************/
-		/// \todo LoRa data arrived
-		/// \todo parse them here
-		/**************************************************************/
-		/**************************************************************/
-		g_task_event_type &= N_LORA_DATA;
-		MYLOG("APP", "Received package over LoRa");
-		MYLOG("APP", "Last RSSI %d", g_last_rssi);
-
-		char log_buff[g_rx_data_len * 3] = {0};
-		uint8_t log_idx = 0;
-		for (int idx = 0; idx < g_rx_data_len; idx++)
+		MYLOG("APP", "P2P TX finished");
+		if (has_rak1921)
 		{
-			sprintf(&log_buff[log_idx], "%02X ", g_rx_lora_data[idx]);
-			log_idx += 3;
+			sprintf(disp_txt, "P2P TX finished");
+			rak1921_add_line(disp_txt);
 		}
-		MYLOG("APP", "%s", log_buff);
 	}
+}
 
-	// LoRa TX finished handling
-	if ((g_task_event_type & LORA_TX_FIN) == LORA_TX_FIN)
-	{
-		g_task_event_type &= N_LORA_TX_FIN;
+/**
+ * @brief Move the raised events into the event queue and handle all queued events
+ *
+ */
+static void app_event_dispatch(void)
+{
+	evq_collect();
 
-		if (g_lorawan_settings.lorawan_enable)
+	app_event_s event;
+	while (evq_pop(&event))
+	{
+		evq_handled(&event);
+		switch (event.type)
 		{
-			if (g_lorawan_settings.confirmed_msg_enabled == LMH_UNCONFIRMED_MSG)
-			{
-				MYLOG("APP", "LPWAN TX cycle finished");
-			}
-			else
-			{
-				MYLOG("APP", "LPWAN TX cycle %s", g_rx_fin_result ? "finished ACK" : "failed NAK");
-			}
-			if (!g_rx_fin_result)
-			{
-				// Increase fail send counter
-				send_fail++;
-
-				if (send_fail == 10)
-				{
-					// Too many failed sendings, reset node and try to rejoin
-					delay(100);
-					api_reset();
-				}
-			}
-		}
-		else
+		case STATUS:
 		{
-			MYLOG("APP", "P2P TX finished");
-			if (has_rak1921)
-			{
-				sprintf(disp_txt, "P2P TX finished");
-				rak1921_add_line(disp_txt);
-			}
+			cycle_wake(event.raised_us);
+			uint32_t start = micros();
+			POWER_STAGE(POWER_STAGE_CYCLE);
+			status_event();
+			POWER_STAGE(POWER_STAGE_WAIT);
+			cycle_done(start);
+			break;
+		}
+		case BLE_DATA:
+			ble_rx_event();
+			break;
+		case LORA_JOIN_FIN:
+			join_fin_event();
+			break;
+		case LORA_DATA:
+			lora_rx_event();
+			break;
+		case LORA_TX_FIN:
+			tx_fin_event();
+			break;
 		}
 	}
 }
+
+/**
+ * @brief Handle events
+ * 		Events can be
+ * 		- timer (setup with AT+SENDINT=xxx)
+ * 		- interrupt events
+ * 		- wake-up signals from other tasks
+ * 		All events go through the event queue, the first handler the API
+ * 		calls handles them in the order they were raised.
+ */
+void app_event_handler(void)
+{
+	blink_leds_timer.start();
+	app_event_dispatch();
+}
+
+/**
+ * @brief Handle BLE events
+ *
+ */
+void ble_data_handler(void)
+{
+	app_event_dispatch();
+}
+
+/**
+ * @brief Handle LoRa events
+ *
+ */
+void lora_data_handler(void)
+{
+	app_event_dispatch();
+}
@@ -13,25 +13,54 @@
 #include <Arduino.h>
 #include <WisBlock-API-V2.h>
 #include "RAK1921_oled.h"
+#include "trace.h"
+#include "boot_log.h"
+#include "power_acct.h"
+#include "i2c_bus.h"
+#include "result_model.h"
+#include "disp_arena.h"
+#include "ram_report.h"
+#include "event_queue.h"
+#include "cycle_stats.h"
+#include "test_plan.h"
+#include "fmt.h"
+#include "crc32.h"
+#include "soak_log.h"
+#include "snapshot.h"
+#include "gpio_loop.h"
 
 // Debug output set to 0 to disable app debug output
 #ifndef MY_DEBUG
 #define MY_DEBUG 1
 #endif
 
-#if MY_DEBUG > 0
-#define MYLOG(tag, ...)                     \
-	do                                      \
-	{                                       \
-		if (tag)                            \
-			PRINTF("[%s] ", tag);           \
-		PRINTF(__VA_ARGS__);                \
-		PRINTF("\n");                       \
-		if (g_ble_uart_is_connected)        \
-		{                                   \
-			g_ble_uart.printf(__VA_ARGS__); \
-			g_ble_uart.printf("\n");        \
-		}                                   \
+// Deferred binary logging, set to 1 to send format ID and raw arguments instead of text
+#ifndef LOG_DEFERRED
+#define LOG_DEFERRED 0
+#endif
+
+#if MY_DEBUG > 0 && LOG_DEFERRED > 0
+#include "log_defer.h"
+#define MYLOG(tag, ...) log_defer(tag, __VA_ARGS__)
+#elif MY_DEBUG > 0
+// Until USB is connected the output goes into the early log buffer (FAST_BOOT)
+#define MYLOG(tag, ...)                         \
+	do                                          \
+	{                                           \
+		if (boot_log_active())                  \
+		{                                       \
+			boot_log_printf(tag, __VA_ARGS__);  \
+			break;                              \
+		}                                       \
+		if (tag)                                \
+			PRINTF("[%s] ", tag);               \
+		PRINTF(__VA_ARGS__);                    \
+		PRINTF("\n");                           \
+		if (g_ble_uart_is_connected)            \
+		{                                       \
+			g_ble_uart.printf(__VA_ARGS__);     \
+			g_ble_uart.printf("\n");            \
+		}                                       \
 	} while (0)
 #else
 #define MYLOG(...)
@@ -54,10 +83,17 @@ void lora_data_handler(void);
 // EPD
 void status_rak14000(void);
 bool init_rak14000(void);
+bool rak14000_alloc(void);
 void rak14000_text(int16_t x, int16_t y, char *text, uint16_t text_color, uint32_t text_size);
 void rak14000_logo(int16_t x, int16_t y);
 void clear_rak14000(void);
 void refresh_rak14000(void);
+void compose_rak14000(void);
+void rak14000_result_view(uint32_t changed);
+uint32_t rak14000_crc(void);
+extern bool epd_use_blit;
+/** Size of the RAK14000 display buffer */
+#define EPD_BUFFER_SIZE 4000
 #define POWER_ENABLE WB_IO2
 
 // GNSS functions
@@ -72,11 +108,62 @@ extern SemaphoreHandle_t g_gnss_sem;
 extern TaskHandle_t gnss_task_handle;
 extern volatile bool last_read_ok;
 extern uint8_t gnss_option;
-extern bool gnss_ok;
+extern int32_t accuracy;
+extern byte fix_type;
+extern uint8_t last_sat_num;
 extern bool has_rak12500;
 
-extern bool flash_success;
-extern uint8_t lora_success;
 extern bool has_rak1921;
+extern bool has_rak14000;
+extern char disp_txt[];
+/** Size of disp_txt, lines longer than the OLED line are cut anyway */
+#define DISP_TXT_SIZE 64
+
+// SPI flash
+/** SPI clock of the flash test, the SPIM of the nRF52840 can do 32 MHz, the module connector limits it */
+#ifndef SFLASH_SPI_CLOCK
+#define SFLASH_SPI_CLOCK 8000000
+#endif
+/** Result of the SPI flash test */
+struct sflash_result_s
+{
+	uint32_t jedec_id;	 // manufacturer, type, capacity code
+	uint32_t size;		 // size in bytes, 0 if no chip
+	uint32_t erase_us;	 // time to erase 64 kB
+	uint32_t program_us; // time to program 64 kB
+	uint32_t read_us;	 // time to read 64 kB
+	bool tested;		 // throughput test was run
+	bool crc_ok;		 // data read back matches
+};
+bool init_rak15001(void);
+bool rak15001_throughput(void);
+void rak15001_report(char *buff, size_t buff_size);
+extern bool has_rak15001;
+
+// Hardware tests
+bool test_oled(void);
+bool test_epd(void);
+uint8_t test_i2c(void);
+bool test_i2c_margin(void);
+void get_i2c_margin_line(char *buff, size_t buff_size);
+void get_i2c_device_line(char *buff, size_t buff_size);
+bool test_gnss(void);
+bool test_flash(void);
+bool test_lora(void);
+bool probe_sflash(void);
+bool test_sflash(void);
+bool test_gpio(void);
+float test_battery(void);
+extern uint8_t i2c_num_dev;
+/** Max number of I2C devices kept for the clock margin test */
+#define I2C_MAX_FOUND 16
+extern uint8_t i2c_found_addr[];
+extern const char *i2c_found_name[];
+
+// Benchmarks
+#ifndef HW_BENCHMARK
+#define HW_BENCHMARK 0
+#endif
+void run_benchmarks(void);
 
 #endif // _MAIN_H_
\ No newline at end of file
@@ -0,0 +1,229 @@
+/**
+ * @file power_acct.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Power state residency and energy estimate per test stage
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The time between two state changes is added to the buckets of the state
+ * that was active, separate for each test stage:
+ * - CPU: active (any task but idle, ISRs), idle (idle task) or sleep
+ *   (tickless idle, System ON with WFE)
+ * - SX1262: TX or RX, from the state of the radio driver. The DIO1 IRQ of the
+ *   SX1262 wakes the LoRa task, so every radio state change comes with a task switch.
+ * - WB_IO2 rail (RAK12500, RAK14000) and RAK1921 OLED on time
+ * Times are counted with the RTC1 of the FreeRTOS tick, it runs in all sleep modes.
+ * The charge is estimated from the times and the current table in power_acct.h.
+ */
+#include "main.h"
+#include <radio/radio.h>
+
+#if APP_POWER > 0
+
+/** Clock of the RTC1 counter */
+#define POWER_CLOCK_HZ 32768
+
+/** Time buckets */
+#define PWR_ACTIVE 0
+#define PWR_IDLE 1
+#define PWR_SLEEP 2
+#define PWR_TX 3
+#define PWR_RX 4
+#define PWR_IO2 5
+#define PWR_OLED 6
+#define PWR_NUM_BUCKETS 7
+
+/** Current of each bucket in uA */
+static const uint32_t power_current[PWR_NUM_BUCKETS] = {
+	POWER_UA_ACTIVE, POWER_UA_IDLE, POWER_UA_SLEEP, POWER_UA_TX, POWER_UA_RX, POWER_UA_IO2, POWER_UA_OLED};
+
+/** Names for the report */
+static const char *power_stage_names[POWER_NUM_STAGES] = {"BOOT", "WAIT", "CYCLE", "GNSS", "TEST"};
+
+/** RTC ticks per stage and bucket */
+static uint64_t power_ticks[POWER_NUM_STAGES][PWR_NUM_BUCKETS];
+
+/** State since the last change */
+static uint32_t power_last_rtc = 0;
+static uint8_t power_cpu = PWR_ACTIVE;
+static uint8_t power_cur_stage = POWER_STAGE_BOOT;
+/** Flag if the idle task is running, kept while sleeping */
+static bool power_in_idle = false;
+
+/** Number of test cycles */
+static uint32_t power_cycles = 0;
+
+/**
+ * @brief Check if the WB_IO2 rail is switched on
+ *
+ * @return true if the output is high
+ */
+static bool power_io2_on(void)
+{
+	uint32_t pin = g_ADigitalPinMap[WB_IO2];
+	NRF_GPIO_Type *port = pin >= 32 ? NRF_P1 : NRF_P0;
+	return (port->OUT & (1UL << (pin & 31))) != 0;
+}
+
+/**
+ * @brief Add the time since the last change to the buckets of the previous state
+ * 		Can be called from tasks, ISRs and the FreeRTOS kernel hooks.
+ *
+ * @param cpu new CPU state
+ */
+static void power_account(uint8_t cpu)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	uint32_t rtc = NRF_RTC1->COUNTER;
+	// 24 bit counter, wraps after 512 s, the tick interrupt or the test cycle wake up earlier
+	uint32_t ticks = (rtc - power_last_rtc) & 0x00FFFFFF;
+	power_last_rtc = rtc;
+
+	uint64_t *stage = power_ticks[power_cur_stage];
+	stage[power_cpu] += ticks;
+	RadioState_t radio = Radio.GetStatus();
+	if (radio == RF_TX_RUNNING)
+	{
+		stage[PWR_TX] += ticks;
+	}
+	else if ((radio == RF_RX_RUNNING) || (radio == RF_CAD))
+	{
+		stage[PWR_RX] += ticks;
+	}
+	if (power_io2_on())
+	{
+		stage[PWR_IO2] += ticks;
+	}
+	if (has_rak1921)
+	{
+		stage[PWR_OLED] += ticks;
+	}
+	power_cpu = cpu;
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief FreeRTOS hook, called after the scheduler selected a new task
+ *
+ * @param is_idle 1 if the new task is the idle task
+ */
+void power_task_switched_in(uint8_t is_idle)
+{
+	power_in_idle = is_idle != 0;
+	power_account(power_in_idle ? PWR_IDLE : PWR_ACTIVE);
+}
+
+/**
+ * @brief FreeRTOS hook, tickless idle starts
+ *
+ */
+void power_sleep_begin(void)
+{
+	power_account(PWR_SLEEP);
+}
+
+/**
+ * @brief FreeRTOS hook, tickless idle ended
+ *
+ */
+void power_sleep_end(void)
+{
+	power_account(power_in_idle ? PWR_IDLE : PWR_ACTIVE);
+}
+
+/**
+ * @brief Switch to another test stage
+ *
+ * @param stage POWER_STAGE_xxx
+ */
+void power_stage(uint8_t stage)
+{
+	if (stage >= POWER_NUM_STAGES)
+	{
+		return;
+	}
+	power_account(power_cpu);
+	if ((stage == POWER_STAGE_CYCLE) && (power_cur_stage == POWER_STAGE_WAIT))
+	{
+		power_cycles++;
+	}
+	power_cur_stage = stage;
+}
+
+/**
+ * @brief Get the estimated charge of a stage
+ *
+ * @param stage POWER_STAGE_xxx
+ * @return uint64_t charge in nAh
+ */
+static uint64_t power_charge(uint8_t stage)
+{
+	uint64_t charge = 0;
+	for (uint8_t bucket = 0; bucket < PWR_NUM_BUCKETS; bucket++)
+	{
+		charge += power_ticks[stage][bucket] * power_current[bucket];
+	}
+	return charge * 1000 / (POWER_CLOCK_HZ * 3600ULL);
+}
+
+/**
+ * @brief Create a line with the times of a stage
+ * 		Format: <stage>,<active ms>,<idle ms>,<sleep ms>,<tx ms>,<rx ms>,<io2 ms>,<oled ms>,<uAh>
+ *
+ * @param stage POWER_STAGE_xxx
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void power_report_stage(uint8_t stage, char *buff, size_t buff_size)
+{
+	power_account(power_cpu);
+	int len = snprintf(buff, buff_size, "%s", power_stage_names[stage]);
+	for (uint8_t bucket = 0; bucket < PWR_NUM_BUCKETS; bucket++)
+	{
+		if ((len < 0) || ((size_t)len >= buff_size))
+		{
+			return;
+		}
+		len += snprintf(&buff[len], buff_size - len, ",%ld", (uint32_t)(power_ticks[stage][bucket] * 1000 / POWER_CLOCK_HZ));
+	}
+	if ((len >= 0) && ((size_t)len < buff_size))
+	{
+		snprintf(&buff[len], buff_size - len, ",%ld", (uint32_t)(power_charge(stage) / 1000));
+	}
+}
+
+/**
+ * @brief Create a line with the totals
+ * 		Format: CYCLES=<n>,MAH_CYCLE=<mAh per test cycle>,MAH_TOTAL=<mAh since boot>
+ * 		A test cycle is the STATUS cycle with GNSS plus the wait for the next cycle.
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void power_report(char *buff, size_t buff_size)
+{
+	power_account(power_cpu);
+	uint64_t total = 0;
+	for (uint8_t stage = 0; stage < POWER_NUM_STAGES; stage++)
+	{
+		total += power_charge(stage);
+	}
+	uint64_t cycle = power_charge(POWER_STAGE_WAIT) + power_charge(POWER_STAGE_CYCLE) + power_charge(POWER_STAGE_GNSS);
+	uint32_t per_cycle = power_cycles != 0 ? (uint32_t)(cycle / power_cycles) : 0;
+	snprintf(buff, buff_size, "CYCLES=%ld,MAH_CYCLE=%ld.%06ld,MAH_TOTAL=%ld.%06ld", power_cycles,
+			 per_cycle / 1000000, per_cycle % 1000000, (uint32_t)(total / 1000000), (uint32_t)(total % 1000000));
+}
+
+#else
+void power_report_stage(uint8_t stage, char *buff, size_t buff_size)
+{
+	buff[0] = 0;
+}
+void power_report(char *buff, size_t buff_size)
+{
+	snprintf(buff, buff_size, "Power accounting not enabled, build with -DAPP_POWER=1");
+}
+#endif
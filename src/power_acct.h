@@ -0,0 +1,95 @@
+/**
+ * @file power_acct.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Power state residency and energy estimate per test stage
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Enabled with -DAPP_POWER=1 (see env:wiscore_rak4631_power in platformio.ini).
+ * Like trace.h this header is force included into all sources of the power
+ * build, including the FreeRTOS kernel, to install the tickless idle and task
+ * switch hooks. It must stay C compatible.
+ */
+#ifndef POWER_ACCT_H
+#define POWER_ACCT_H
+#include <stdint.h>
+#include <stddef.h>
+#include "trace.h"
+
+#ifndef APP_POWER
+#define APP_POWER 0
+#endif
+
+/** Test stages */
+#define POWER_STAGE_BOOT 0	// boot tests in init_app()
+#define POWER_STAGE_WAIT 1	// waiting for the next test cycle
+#define POWER_STAGE_CYCLE 2 // STATUS test cycle without GNSS
+#define POWER_STAGE_GNSS 3	// GNSS poll of the test cycle
+#define POWER_STAGE_TEST 4	// tests started with AT+TEST
+#define POWER_NUM_STAGES 5
+
+/** Current table in uA, can be changed with build flags */
+#ifndef POWER_UA_ACTIVE
+#define POWER_UA_ACTIVE 3300 // nRF52840 CPU running at 64 MHz from flash, DC/DC on
+#endif
+#ifndef POWER_UA_IDLE
+#define POWER_UA_IDLE 3300 // idle task running, tick not suppressed
+#endif
+#ifndef POWER_UA_SLEEP
+#define POWER_UA_SLEEP 5 // System ON sleep, RTC running
+#endif
+#ifndef POWER_UA_TX
+#define POWER_UA_TX 118000 // SX1262 TX at +22 dBm
+#endif
+#ifndef POWER_UA_RX
+#define POWER_UA_RX 5300 // SX1262 RX, boosted gain
+#endif
+#ifndef POWER_UA_IO2
+#define POWER_UA_IO2 25000 // WB_IO2 rail with RAK12500 acquiring and RAK14000
+#endif
+#ifndef POWER_UA_OLED
+#define POWER_UA_OLED 8000 // RAK1921 on the always on 3V3 rail
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+	void power_task_switched_in(uint8_t is_idle);
+	void power_sleep_begin(void);
+	void power_sleep_end(void);
+	void power_stage(uint8_t stage);
+#ifdef __cplusplus
+}
+#endif
+
+#if APP_POWER > 0
+// FreeRTOS kernel hooks, the task switch hook is expanded in tasks.c where the idle task handle is known
+#define traceLOW_POWER_IDLE_BEGIN() power_sleep_begin()
+#define traceLOW_POWER_IDLE_END() power_sleep_end()
+#if APP_TRACE > 0
+#undef traceTASK_SWITCHED_IN
+#define traceTASK_SWITCHED_IN()                                                 \
+	do                                                                          \
+	{                                                                           \
+		trace_task_switched_in();                                               \
+		power_task_switched_in((void *)pxCurrentTCB == (void *)xIdleTaskHandle); \
+	} while (0)
+#else
+#define traceTASK_SWITCHED_IN() power_task_switched_in((void *)pxCurrentTCB == (void *)xIdleTaskHandle)
+#endif
+
+/** Switch to another test stage */
+#define POWER_STAGE(stage) power_stage(stage)
+#else
+#define POWER_STAGE(stage)
+#endif
+
+#ifdef __cplusplus
+void power_report_stage(uint8_t stage, char *buff, size_t buff_size);
+void power_report(char *buff, size_t buff_size);
+#endif
+
+#endif // POWER_ACCT_H
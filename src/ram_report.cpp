@@ -0,0 +1,119 @@
+/**
+ * @file ram_report.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Run-time RAM usage: statics, heap, display arena and task stacks
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The sizes come from the linker symbols, the heap usage from mallinfo().
+ * FreeRTOS uses heap_3 (malloc), task stacks are part of the heap.
+ * The heap low-water mark is taken from the highest break of malloc,
+ * newlib-nano never returns memory to the break.
+ * The build-time report is printed by ram_report.py after linking.
+ */
+#include "main.h"
+#include <malloc.h>
+
+extern "C"
+{
+	extern char __data_start__;
+	extern char __data_end__;
+	extern char __bss_start__;
+	extern char __bss_end__;
+	extern char __HeapBase;
+	extern char __HeapLimit;
+}
+
+/** Snapshot of the task list */
+static char ram_task_name[RAM_MAX_TASKS][configMAX_TASK_NAME_LEN];
+static uint32_t ram_task_free[RAM_MAX_TASKS];
+static uint8_t ram_num_tasks = 0;
+
+/**
+ * @brief Create a compact line with the RAM usage
+ * 		Format: STATIC=30668,HEAP=204852,USED=12000,FREE=192852,MINFREE=190000,ARENA=5280
+ * 		All values in bytes
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void ram_report_line(char *buff, size_t buff_size)
+{
+	struct mallinfo info = mallinfo();
+	uint32_t statics = (&__data_end__ - &__data_start__) + (&__bss_end__ - &__bss_start__);
+	uint32_t heap = &__HeapLimit - &__HeapBase;
+	uint32_t used = info.uordblks;
+	snprintf(buff, buff_size, "STATIC=%ld,HEAP=%ld,USED=%ld,FREE=%ld,MINFREE=%ld,ARENA=%d",
+			 statics, heap, used, heap - used, heap - (uint32_t)info.arena, disp_arena_size());
+}
+
+/**
+ * @brief Take a snapshot of the stack high-water marks of all tasks
+ *
+ * @return uint8_t number of tasks
+ */
+uint8_t ram_report_tasks(void)
+{
+#if configUSE_TRACE_FACILITY == 1
+	static TaskStatus_t status[RAM_MAX_TASKS];
+	ram_num_tasks = uxTaskGetSystemState(status, RAM_MAX_TASKS, NULL);
+	for (uint8_t idx = 0; idx < ram_num_tasks; idx++)
+	{
+		snprintf(ram_task_name[idx], configMAX_TASK_NAME_LEN, "%s", status[idx].pcTaskName);
+		ram_task_free[idx] = status[idx].usStackHighWaterMark * sizeof(StackType_t);
+	}
+#else
+	// Without the trace facility only the calling task is known
+	snprintf(ram_task_name[0], configMAX_TASK_NAME_LEN, "%s", pcTaskGetName(NULL));
+	ram_task_free[0] = uxTaskGetStackHighWaterMark(NULL) * sizeof(StackType_t);
+	ram_num_tasks = 1;
+#endif
+	return ram_num_tasks;
+}
+
+/**
+ * @brief Get a line of the task snapshot
+ * 		Format: TASK=<name>,<bytes never used on the stack>
+ *
+ * @param idx task index
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ * @return true if the task exists
+ * @return false if idx is out of range
+ */
+bool ram_report_task_line(uint8_t idx, char *buff, size_t buff_size)
+{
+	if (idx >= ram_num_tasks)
+	{
+		return false;
+	}
+	snprintf(buff, buff_size, "TASK=%s,%ld", ram_task_name[idx], ram_task_free[idx]);
+	return true;
+}
+
+/**
+ * @brief Write the RAM report and the display buffers to the log
+ *
+ */
+void ram_report_log(void)
+{
+	char line[128];
+	ram_report_line(line, sizeof(line));
+	MYLOG("RAM", "%s", line);
+
+	const disp_claim_s *claims;
+	uint8_t num_claims = disp_arena_claims(&claims);
+	for (uint8_t idx = 0; idx < num_claims; idx++)
+	{
+		MYLOG("RAM", "ARENA=%s,%d", claims[idx].owner, claims[idx].size);
+	}
+
+	uint8_t num_tasks = ram_report_tasks();
+	for (uint8_t idx = 0; idx < num_tasks; idx++)
+	{
+		ram_report_task_line(idx, line, sizeof(line));
+		MYLOG("RAM", "%s", line);
+	}
+}
@@ -0,0 +1,23 @@
+/**
+ * @file ram_report.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Run-time RAM usage: statics, heap, display arena and task stacks
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef RAM_REPORT_H
+#define RAM_REPORT_H
+#include <Arduino.h>
+
+/** Max number of tasks in the report */
+#define RAM_MAX_TASKS 16
+
+void ram_report_line(char *buff, size_t buff_size);
+uint8_t ram_report_tasks(void);
+bool ram_report_task_line(uint8_t idx, char *buff, size_t buff_size);
+void ram_report_log(void);
+
+#endif // RAM_REPORT_H
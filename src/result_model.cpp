@@ -0,0 +1,114 @@
+/**
+ * @file result_model.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Test results with change notification for the display views
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The tests write their results with result_set(). Changes are collected
+ * and sent to the views (OLED, EPD) with result_publish(), so a slow EPD
+ * refresh is done once for a group of tests and only if a field it shows
+ * has changed.
+ */
+#include "main.h"
+
+/** Names of the fields, used for serialization */
+static const char *result_names[RESULT_NUM_FIELDS] = {"OLED", "EPD", "I2C", "FLASH", "LORA", "TX", "GNSS", "BATT", "SFLASH"};
+
+/** Values of the fields */
+static int32_t result_values[RESULT_NUM_FIELDS] = {0, 0, 0, 0, 0, 2, 2, 0, 0};
+
+/** Fields changed since the last publish, all fields for the first render */
+static uint32_t result_changed = RESULT_BIT(RESULT_NUM_FIELDS) - 1;
+
+/** Subscribed views */
+static result_view_t result_views[RESULT_MAX_VIEWS];
+static uint8_t result_num_views = 0;
+
+/**
+ * @brief Set a field, marks it as changed if the value is different
+ *
+ * @param field field to set
+ * @param value new value
+ */
+void result_set(result_field_e field, int32_t value)
+{
+	if (result_values[field] != value)
+	{
+		result_values[field] = value;
+		result_changed |= RESULT_BIT(field);
+	}
+}
+
+/**
+ * @brief Get the value of a field
+ *
+ * @param field field
+ * @return int32_t value
+ */
+int32_t result_get(result_field_e field)
+{
+	return result_values[field];
+}
+
+/**
+ * @brief Add a view, a new view gets all fields on the next publish
+ *
+ * @param view callback of the view
+ * @return true if the view was added or is already subscribed
+ * @return false if there is no space for more views
+ */
+bool result_subscribe(result_view_t view)
+{
+	for (uint8_t idx = 0; idx < result_num_views; idx++)
+	{
+		if (result_views[idx] == view)
+		{
+			return true;
+		}
+	}
+	if (result_num_views == RESULT_MAX_VIEWS)
+	{
+		return false;
+	}
+	result_views[result_num_views++] = view;
+	result_changed = RESULT_BIT(RESULT_NUM_FIELDS) - 1;
+	return true;
+}
+
+/**
+ * @brief Send the changed fields to all views
+ *
+ */
+void result_publish(void)
+{
+	uint32_t changed = result_changed;
+	result_changed = 0;
+	if (changed == 0)
+	{
+		return;
+	}
+	for (uint8_t idx = 0; idx < result_num_views; idx++)
+	{
+		result_views[idx](changed);
+	}
+}
+
+/**
+ * @brief Create a compact line with all test results
+ * 		Format: OLED=1,EPD=0,I2C=3,FLASH=1,LORA=1,TX=2,GNSS=0,BATT=4012
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void result_serialize(char *buff, size_t buff_size)
+{
+	size_t len = 0;
+	buff[0] = 0;
+	for (uint8_t field = 0; (field < RESULT_NUM_FIELDS) && (len < buff_size); field++)
+	{
+		len += snprintf(&buff[len], buff_size - len, "%s%s=%ld", field == 0 ? "" : ",", result_names[field], result_values[field]);
+	}
+}
@@ -0,0 +1,45 @@
+/**
+ * @file result_model.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Test results with change notification for the display views
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef RESULT_MODEL_H
+#define RESULT_MODEL_H
+#include <Arduino.h>
+
+/** Fields of the test result model */
+enum result_field_e
+{
+	RESULT_OLED = 0, // 1 = RAK1921 found
+	RESULT_EPD,		 // 1 = RAK14000 found
+	RESULT_I2C,		 // number of I2C devices
+	RESULT_FLASH,	 // 1 = Write-Read test ok
+	RESULT_LORA,	 // 1 = SX1262 sync word ok
+	RESULT_TX,		 // 0 = sent, 1 = failed, 2 = not tested yet
+	RESULT_GNSS,	 // 0 = no location, 1 = location or module initialized, 2 = no module
+	RESULT_BATT,	 // battery voltage in mV
+	RESULT_SFLASH,	 // 0 = no SPI flash, 1 = SPI flash test ok, 2 = SPI flash test failed, 3 = SPI flash found, not tested
+	RESULT_NUM_FIELDS
+};
+
+/** Bit of a field in the change mask */
+#define RESULT_BIT(field) (1UL << (field))
+
+/** Max number of views */
+#define RESULT_MAX_VIEWS 4
+
+/** View callback, gets a mask of the changed fields */
+typedef void (*result_view_t)(uint32_t changed);
+
+void result_set(result_field_e field, int32_t value);
+int32_t result_get(result_field_e field);
+bool result_subscribe(result_view_t view);
+void result_publish(void);
+void result_serialize(char *buff, size_t buff_size);
+
+#endif // RESULT_MODEL_H
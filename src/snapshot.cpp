@@ -0,0 +1,121 @@
+/**
+ * @file snapshot.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Render snapshots of the display and report paths for regression checks
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * AT+SNAP renders a fixed set of results and log lines through the same
+ * paths the tests use: result line, OLED status bar, OLED log and EPD compose.
+ * For each path it reports the CRC-32 of the output (text or framebuffer),
+ * the CPU cycles, and the I2C transactions and bus time to the OLED.
+ * tools/snap_check.py compares the lines with a golden file and fails if
+ * an output changed or cycles or bus time grew beyond a threshold.
+ * The real results are restored and published afterwards, the OLED log
+ * is cleared by the snapshot.
+ * test/host/test_snapshot.cpp runs the same scenario (snapshot_scenario.h)
+ * on the PC against golden files.
+ */
+#include "main.h"
+#include "snapshot_scenario.h"
+
+/** Values at the start of a path */
+static uint32_t snap_cycles;
+static uint32_t snap_i2c_trans;
+static uint32_t snap_i2c_us;
+
+/**
+ * @brief Start the measurement of a path
+ *
+ */
+static void snap_begin(void)
+{
+	i2c_device_s *oled = i2c_bus_find(0x3c);
+	snap_i2c_trans = oled != NULL ? oled->transactions : 0;
+	snap_i2c_us = oled != NULL ? oled->busy_us : 0;
+	snap_cycles = DWT->CYCCNT;
+}
+
+/**
+ * @brief End the measurement of a path and send the result
+ * 		Line: +SNAP:<path>,<CRC-32>,<cycles>,<I2C transactions>,<I2C bus us>
+ *
+ * @param path name of the path
+ * @param crc CRC-32 of the output
+ */
+static void snap_end(const char *path, uint32_t crc)
+{
+	uint32_t cycles = DWT->CYCCNT - snap_cycles;
+	i2c_device_s *oled = i2c_bus_find(0x3c);
+	uint32_t trans = oled != NULL ? oled->transactions - snap_i2c_trans : 0;
+	uint32_t busy_us = oled != NULL ? oled->busy_us - snap_i2c_us : 0;
+	AT_PRINTF("+SNAP:%s,%08lX,%ld,%ld,%ld", path, crc, cycles, trans, busy_us);
+}
+
+/**
+ * @brief Run the snapshot scenario
+ *
+ */
+void snapshot_run(void)
+{
+	// Cycle counter, may be enabled already by the benchmark or trace build
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	int32_t saved[RESULT_NUM_FIELDS];
+	for (uint8_t field = 0; field < RESULT_NUM_FIELDS; field++)
+	{
+		saved[field] = result_get((result_field_e)field);
+		result_set((result_field_e)field, snap_results[field]);
+	}
+
+	// Result line, as sent by AT+RESULT?
+	char line[96];
+	snap_begin();
+	result_serialize(line, sizeof(line));
+	snap_end("RESULT", crc32_update(CRC32_INIT, (uint8_t *)line, strlen(line)));
+
+	if (has_rak1921)
+	{
+		// Status bar
+		rak1921_header_invalidate();
+		snap_begin();
+		rak1921_result_view(RESULT_BIT(RESULT_NUM_FIELDS) - 1);
+		snap_end("OLED_HEADER", rak1921_crc());
+
+		// Log lines, each line updates the display
+		rak1921_clear();
+		snap_begin();
+		for (uint8_t idx = 0; idx < SNAP_NUM_LINES; idx++)
+		{
+			rak1921_add_line((char *)snap_lines[idx]);
+		}
+		snap_end("OLED_LINES", rak1921_crc());
+	}
+	else
+	{
+		AT_PRINTF("+SNAP:OLED_HEADER,NA");
+		AT_PRINTF("+SNAP:OLED_LINES,NA");
+	}
+
+	if (has_rak14000)
+	{
+		// Result screen without the panel refresh
+		snap_begin();
+		compose_rak14000();
+		snap_end("EPD_COMPOSE", rak14000_crc());
+	}
+	else
+	{
+		AT_PRINTF("+SNAP:EPD_COMPOSE,NA");
+	}
+
+	// Show the real results again
+	for (uint8_t field = 0; field < RESULT_NUM_FIELDS; field++)
+	{
+		result_set((result_field_e)field, saved[field]);
+	}
+	result_publish();
+}
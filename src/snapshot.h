@@ -0,0 +1,17 @@
+/**
+ * @file snapshot.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Render snapshots of the display and report paths for regression checks
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+#include <Arduino.h>
+
+void snapshot_run(void);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,33 @@
+/**
+ * @file snapshot_scenario.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Fixed results and log lines rendered by AT+SNAP and by the host snapshot test
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Included only by snapshot.cpp and test/host/test_snapshot.cpp, so the
+ * on-target and the host golden files are made from the same scenario.
+ */
+#ifndef SNAPSHOT_SCENARIO_H
+#define SNAPSHOT_SCENARIO_H
+#include "result_model.h"
+
+/** Results of the snapshot scenario */
+static const int32_t snap_results[RESULT_NUM_FIELDS] = {1, 1, 3, 1, 1, 2, 1, 3333, 1};
+
+/** Lines of the snapshot scenario */
+static const char *const snap_lines[] = {
+	"RAK Test Firmware",
+	"Found 3 I2C devices",
+	"Flash Write-Read test #1 success",
+	"Fix: Fix type 3D Sat: 9",
+	"L: -27.4789700:153.0410440",
+	"Alt: 35.000, Acry 1.20",
+};
+
+/** Number of lines of the snapshot scenario */
+#define SNAP_NUM_LINES (sizeof(snap_lines) / sizeof(snap_lines[0]))
+
+#endif // SNAPSHOT_SCENARIO_H
@@ -0,0 +1,294 @@
+/**
+ * @file soak_log.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Delta encoded trend log of battery, RSSI and GNSS quality for soak tests
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * For burn-in the testers run for days. With SOAK_TEST=1 the first test cycle
+ * after boot and then one cycle every SOAK_PERIOD seconds add a sample to an
+ * append-only log on InternalFS.
+ * Each value is stored as the difference to the previous sample, zig-zag
+ * encoded as varint, so a sample with small changes needs 7 to 9 bytes.
+ * The log is a sequence of segments. A segment starts at each boot and at
+ * each new file, all values restart from 0 there, so every file can be
+ * decoded on its own. A short write is cut off again, so a failed write
+ * only loses the buffered samples.
+ * When the file is full it is renamed to SOAK_FILE_OLD and a new file is
+ * started, the log always holds the last 1 to 2 x SOAK_FILE_SIZE bytes.
+ * With the defaults (2 x 8 kB, 600 s, 8 to 9 bytes per sample) that is
+ * the last 6 to 14 days.
+ * Export with AT+SOAKDUMP, decode with tools/soak_decode.py.
+ */
+#include "main.h"
+#include <Adafruit_LittleFS.h>
+#include <InternalFileSystem.h>
+
+using namespace Adafruit_LittleFS_Namespace;
+
+/** Max size of one record, tag + 6 varints */
+#define SOAK_RECORD_MAX (1 + 6 * 5)
+
+/** Samples not yet written to flash */
+static uint8_t soak_buf[SOAK_FLUSH * SOAK_RECORD_MAX + 2];
+static uint16_t soak_buf_len = 0;
+static uint8_t soak_buf_samples = 0;
+
+/** Last sample of the segment */
+static soak_sample_s soak_last;
+/** Flag if the current file has an open segment */
+static bool soak_in_segment = false;
+/** Flag if the soak log is running */
+static bool soak_active = false;
+/** Uptime of the last sample in seconds */
+static uint32_t soak_last_time = 0;
+
+/** Sizes of the files in flash */
+static uint32_t soak_file_len = 0;
+static uint32_t soak_old_len = 0;
+/** Statistics */
+static uint32_t soak_samples = 0;
+static uint32_t soak_errors = 0;
+
+/**
+ * @brief Add a varint to the buffer, 7 bits per byte, low bits first
+ *
+ * @param value value
+ */
+static void soak_put_varint(uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		soak_buf[soak_buf_len++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	soak_buf[soak_buf_len++] = (uint8_t)value;
+}
+
+/**
+ * @brief Add the difference to the last value as zig-zag varint
+ * 		Zig-zag maps 0, -1, 1, -2 ... to 0, 1, 2, 3 ... so small negative steps stay short
+ *
+ * @param value new value
+ * @param last last value, updated
+ */
+static void soak_put_delta(int32_t value, int32_t &last)
+{
+	int32_t delta = value - last;
+	last = value;
+	soak_put_varint(((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31));
+}
+
+/**
+ * @brief Get the size of a file
+ *
+ * @param name file name
+ * @return uint32_t size in bytes, 0 if the file does not exist
+ */
+static uint32_t soak_file_size(const char *name)
+{
+	File file(InternalFS);
+	if (!file.open(name, FILE_O_READ))
+	{
+		return 0;
+	}
+	uint32_t size = file.size();
+	file.close();
+	return size;
+}
+
+/**
+ * @brief Keep the full file as SOAK_FILE_OLD and start a new file
+ *
+ */
+static void soak_rotate(void)
+{
+	if (InternalFS.exists(SOAK_FILE_OLD))
+	{
+		InternalFS.remove(SOAK_FILE_OLD);
+	}
+	InternalFS.rename(SOAK_FILE_NAME, SOAK_FILE_OLD);
+	soak_old_len = soak_file_len;
+	soak_file_len = 0;
+	soak_in_segment = false;
+}
+
+/**
+ * @brief Start the soak log, a new segment is started with the first sample
+ *
+ */
+void soak_init(void)
+{
+#if SOAK_TEST > 0
+	InternalFS.begin();
+	soak_file_len = soak_file_size(SOAK_FILE_NAME);
+	soak_old_len = soak_file_size(SOAK_FILE_OLD);
+	soak_in_segment = false;
+	soak_active = true;
+	MYLOG("SOAK", "Soak log %ld + %ld bytes", soak_file_len, soak_old_len);
+#endif
+}
+
+/**
+ * @brief Add a sample of the current test cycle
+ * 		Call after the battery was read
+ *
+ */
+void soak_sample(void)
+{
+	uint32_t now = millis() / 1000;
+	if (!soak_active || ((soak_samples != 0) && (now - soak_last_time < SOAK_PERIOD)))
+	{
+		return;
+	}
+	soak_last_time = now;
+
+	// Start a new file if the record might not fit
+	if (soak_file_len + soak_buf_len + SOAK_RECORD_MAX > SOAK_FILE_SIZE)
+	{
+		soak_flush();
+		soak_rotate();
+	}
+
+	if (!soak_in_segment)
+	{
+		soak_buf[soak_buf_len++] = SOAK_TAG_SEGMENT;
+		soak_put_varint(SOAK_VERSION);
+		memset(&soak_last, 0, sizeof(soak_last));
+		soak_in_segment = true;
+	}
+
+	soak_buf[soak_buf_len++] = SOAK_TAG_SAMPLE;
+	soak_put_delta(now, soak_last.time_s);
+	soak_put_delta(result_get(RESULT_BATT), soak_last.batt_mv);
+	soak_put_delta(g_last_rssi, soak_last.rssi);
+	soak_put_delta(has_rak12500 ? last_sat_num : 0, soak_last.sats);
+	soak_put_delta(has_rak12500 ? accuracy : 0, soak_last.hdop);
+	soak_put_delta(has_rak12500 ? fix_type : 0, soak_last.fix);
+	soak_samples++;
+	soak_buf_samples++;
+
+	if (soak_buf_samples >= SOAK_FLUSH)
+	{
+		soak_flush();
+	}
+}
+
+/**
+ * @brief Append the buffered samples to the file
+ * 		If the write fails the samples are lost and a new segment is started.
+ * 		A partly written record can not be decoded, the file is cut back to
+ * 		its last good length, or deleted if that fails.
+ *
+ */
+void soak_flush(void)
+{
+	if (soak_buf_len == 0)
+	{
+		return;
+	}
+	File file(InternalFS);
+	size_t written = 0;
+	if (file.open(SOAK_FILE_NAME, FILE_O_WRITE))
+	{
+		written = file.write(soak_buf, soak_buf_len);
+		bool file_ok = (written == 0) || (written == soak_buf_len) || file.truncate(soak_file_len);
+		file.close();
+		if (!file_ok)
+		{
+			InternalFS.remove(SOAK_FILE_NAME);
+			soak_file_len = 0;
+		}
+	}
+	if (written == soak_buf_len)
+	{
+		soak_file_len += written;
+	}
+	else
+	{
+		soak_errors++;
+		soak_in_segment = false;
+		MYLOG("SOAK", "Write failed");
+	}
+	soak_buf_len = 0;
+	soak_buf_samples = 0;
+}
+
+/**
+ * @brief Delete the soak log
+ *
+ */
+void soak_clear(void)
+{
+	soak_buf_len = 0;
+	soak_buf_samples = 0;
+	soak_in_segment = false;
+	InternalFS.remove(SOAK_FILE_OLD);
+	InternalFS.remove(SOAK_FILE_NAME);
+	soak_file_len = 0;
+	soak_old_len = 0;
+	soak_samples = 0;
+	soak_errors = 0;
+	soak_last_time = 0;
+}
+
+/**
+ * @brief Send a file as hex lines +SOAKDUMP:<hex>
+ *
+ * @param name file name
+ * @param crc CRC-32 of the data sent so far, updated
+ * @return uint32_t number of bytes sent
+ */
+static uint32_t soak_dump_file(const char *name, uint32_t &crc)
+{
+	File file(InternalFS);
+	if (!file.open(name, FILE_O_READ))
+	{
+		return 0;
+	}
+	uint8_t data[32];
+	char line[2 * sizeof(data) + 1];
+	uint32_t total = 0;
+	int len;
+	while ((len = file.read(data, sizeof(data))) > 0)
+	{
+		for (int idx = 0; idx < len; idx++)
+		{
+			FMT(&line[2 * idx], 3, "%02X", data[idx]);
+		}
+		AT_PRINTF("+SOAKDUMP:%s", line);
+		crc = crc32_update(crc, data, len);
+		total += len;
+	}
+	file.close();
+	return total;
+}
+
+/**
+ * @brief Export the soak log, old file first
+ * 		Lines +SOAKDUMP:<hex> and a last line +SOAKDUMP:END,<bytes>,<CRC-32>
+ *
+ */
+void soak_dump(void)
+{
+	soak_flush();
+	uint32_t crc = CRC32_INIT;
+	uint32_t total = soak_dump_file(SOAK_FILE_OLD, crc);
+	total += soak_dump_file(SOAK_FILE_NAME, crc);
+	AT_PRINTF("+SOAKDUMP:END,%ld,%08lX", total, crc);
+}
+
+/**
+ * @brief Create a compact line with the soak log status
+ * 		Format: SOAK=<0|1>,SAMPLES=<n since boot>,BYTES=<in flash>,BUFFERED=<samples>,ERRORS=<n>
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void soak_report(char *buff, size_t buff_size)
+{
+	snprintf(buff, buff_size, "SOAK=%d,SAMPLES=%ld,BYTES=%ld,BUFFERED=%d,ERRORS=%ld", soak_active ? 1 : 0,
+			 soak_samples, soak_file_len + soak_old_len, soak_buf_samples, soak_errors);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file soak_log.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Delta encoded trend log of battery, RSSI and GNSS quality for soak tests
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef SOAK_LOG_H
+#define SOAK_LOG_H
+#include <Arduino.h>
+
+/** Soak test mode, log one sample every SOAK_PERIOD seconds and keep the file system at boot */
+#ifndef SOAK_TEST
+#define SOAK_TEST 0
+#endif
+
+/** Time between two samples in seconds, the test cycle is 30 s, a sample is taken in the first cycle after this time */
+#ifndef SOAK_PERIOD
+#define SOAK_PERIOD 600
+#endif
+
+/** Max size of one log file, the previous file is kept, so the log uses up to 2x this */
+#ifndef SOAK_FILE_SIZE
+#define SOAK_FILE_SIZE 8192
+#endif
+
+/** Samples collected in RAM before they are appended to the file, saves flash erase cycles */
+#ifndef SOAK_FLUSH
+#define SOAK_FLUSH 4
+#endif
+
+/** Log files, the current one and the one before */
+#define SOAK_FILE_NAME "/soak.bin"
+#define SOAK_FILE_OLD "/soak.old"
+
+/** Record tags */
+#define SOAK_TAG_SEGMENT 0x53 // 'S' start of a segment, all values restart from 0, followed by varint version
+#define SOAK_TAG_SAMPLE 0x01  // sample, followed by the varints of soak_sample_s
+#define SOAK_VERSION 1
+
+/** One sample, each value is stored as zig-zag varint of the difference to the last sample */
+struct soak_sample_s
+{
+	int32_t time_s;	 // uptime in seconds
+	int32_t batt_mv; // battery voltage in mV
+	int32_t rssi;	 // RSSI of the last LoRa packet received in dBm
+	int32_t sats;	 // GNSS satellites in view
+	int32_t hdop;	 // GNSS horizontal DOP x 100
+	int32_t fix;	 // GNSS fix type
+};
+
+void soak_init(void);
+void soak_sample(void);
+void soak_flush(void);
+void soak_clear(void);
+void soak_dump(void);
+void soak_report(char *buff, size_t buff_size);
+
+#endif // SOAK_LOG_H
@@ -0,0 +1,241 @@
+/**
+ * @file test_plan.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Compile-time registry of the hardware tests
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Each test is declared once in test_decl with name, bus, dependencies and
+ * enable condition. The dispatch table test_plan is built from it at compile
+ * time (C++11 constexpr). A test that is disabled, or depends on a disabled
+ * test, gets a NULL function pointer. Its code is then not referenced and is
+ * removed by the linker (--gc-sections).
+ * To add a check, add its id to test_id_e and one line to test_decl.
+ * Tests that need a fixture or change the hardware are declared with in_all
+ * false, they run only with AT+TEST=<name>.
+ */
+#include "main.h"
+
+/**
+ * Test wrappers with the common signature
+ */
+static bool run_oled(bool boot)
+{
+	return test_oled();
+}
+
+static bool run_epd(bool boot)
+{
+	return test_epd();
+}
+
+static bool run_i2c(bool boot)
+{
+	return test_i2c() != 0;
+}
+
+static bool run_margin(bool boot)
+{
+	return test_i2c_margin();
+}
+
+static bool run_gnss(bool boot)
+{
+	return test_gnss();
+}
+
+static bool run_flash(bool boot)
+{
+	// The soak log must survive the reboots of a soak test
+	if (boot && (SOAK_TEST == 0))
+	{
+		// Erase flash file system
+		flash_reset();
+		// Save LoRaWAN settings (in case they were still there on top of Meshtastic settings)
+		api_set_credentials();
+	}
+	return test_flash();
+}
+
+static bool run_sflash_id(bool boot)
+{
+	return probe_sflash();
+}
+
+static bool run_sflash(bool boot)
+{
+	return test_sflash();
+}
+
+static bool run_lora(bool boot)
+{
+	return test_lora();
+}
+
+static bool run_batt(bool boot)
+{
+	return test_battery() > 0;
+}
+
+static bool run_gpio(bool boot)
+{
+	return test_gpio();
+}
+
+/** Declaration of a test */
+struct test_decl_s
+{
+	const char *name;
+	test_run_t run;
+	uint8_t bus;
+	uint32_t deps;
+	bool at_cmd;
+	bool in_all;
+	bool enabled;
+};
+
+/** All tests, index is test_id_e */
+constexpr test_decl_s test_decl[] = {
+	{"OLED", run_oled, TEST_BUS_I2C, 0, false, true, TEST_ENABLE_OLED},
+	{"EPD", run_epd, TEST_BUS_SPI, 0, true, true, TEST_ENABLE_EPD},
+	{"I2C", run_i2c, TEST_BUS_I2C, 0, true, true, TEST_ENABLE_I2C},
+	{"MARGIN", run_margin, TEST_BUS_I2C, TEST_DEP(TEST_I2C), true, true, TEST_ENABLE_MARGIN},
+	{"GNSS", run_gnss, TEST_BUS_I2C, TEST_DEP(TEST_I2C), true, true, TEST_ENABLE_GNSS},
+	{"FLASH", run_flash, TEST_BUS_NONE, 0, true, true, TEST_ENABLE_FLASH},
+	// JEDEC ID only, the throughput test erases a block of the chip
+	{"SFLASH_ID", run_sflash_id, TEST_BUS_SPI, 0, true, true, TEST_ENABLE_SFLASH},
+	{"SFLASH", run_sflash, TEST_BUS_SPI, 0, true, false, TEST_ENABLE_SFLASH},
+	{"LORA", run_lora, TEST_BUS_SPI, 0, true, true, TEST_ENABLE_LORA},
+	{"BATT", run_batt, TEST_BUS_ADC, 0, false, true, TEST_ENABLE_BATT},
+	// Drives the IO slot pins, needs the loopback plug
+	{"GPIO", run_gpio, TEST_BUS_GPIO, 0, true, false, TEST_ENABLE_GPIO},
+};
+
+static_assert(sizeof(test_decl) / sizeof(test_decl[0]) == TEST_NUM, "test_decl must have one entry per test_id_e");
+
+/**
+ * @brief Check that all dependencies of the tests run before them
+ */
+constexpr bool test_deps_ordered(size_t id)
+{
+	return id == TEST_NUM ? true : ((test_decl[id].deps >> id) == 0) && test_deps_ordered(id + 1);
+}
+static_assert(test_deps_ordered(0), "A test depends on a test that runs after it");
+
+constexpr bool test_active(size_t id);
+
+/**
+ * @brief Check if all tests in a dependency mask are active
+ */
+constexpr bool test_deps_active(uint32_t deps, size_t id)
+{
+	return id == TEST_NUM ? true : (((deps & TEST_DEP(id)) == 0) || test_active(id)) && test_deps_active(deps, id + 1);
+}
+
+/**
+ * @brief Check if a test is enabled and all its dependencies are active
+ */
+constexpr bool test_active(size_t id)
+{
+	return test_decl[id].enabled && test_deps_active(test_decl[id].deps, 0);
+}
+
+/** C++11 replacement for std::index_sequence */
+template <size_t... S>
+struct test_seq
+{
+};
+template <size_t N, size_t... S>
+struct test_make_seq : test_make_seq<N - 1, N - 1, S...>
+{
+};
+template <size_t... S>
+struct test_make_seq<0, S...>
+{
+	typedef test_seq<S...> type;
+};
+
+/** Dispatch table */
+struct test_table_s
+{
+	test_entry_s entry[TEST_NUM];
+};
+
+template <size_t... S>
+constexpr test_table_s test_build_plan(test_seq<S...>)
+{
+	return test_table_s{{{test_decl[S].name, test_active(S) ? test_decl[S].run : NULL, test_decl[S].bus,
+						  test_decl[S].deps, test_decl[S].at_cmd, test_decl[S].in_all}...}};
+}
+
+/** The test plan, in flash */
+static constexpr test_table_s test_plan = test_build_plan(test_make_seq<TEST_NUM>::type());
+
+/**
+ * @brief Get a test of the plan
+ *
+ * @param id test_id_e
+ * @return const test_entry_s* the test or NULL if id is out of range
+ */
+const test_entry_s *test_plan_entry(uint8_t id)
+{
+	return id < TEST_NUM ? &test_plan.entry[id] : NULL;
+}
+
+/**
+ * @brief Run a single test
+ *
+ * @param id test_id_e
+ * @param boot true if called by the boot sequence
+ * @return true if the test passed
+ * @return false if the test failed or is disabled
+ */
+bool test_plan_run(uint8_t id, bool boot)
+{
+	if ((id >= TEST_NUM) || (test_plan.entry[id].run == NULL))
+	{
+		return false;
+	}
+	return test_plan.entry[id].run(boot);
+}
+
+/**
+ * @brief Run all enabled tests in the plan order, except the tests that run only by name
+ *
+ */
+void test_plan_boot(void)
+{
+	for (uint8_t id = 0; id < TEST_NUM; id++)
+	{
+		if ((test_plan.entry[id].run != NULL) && test_plan.entry[id].in_all)
+		{
+			test_plan.entry[id].run(true);
+		}
+	}
+}
+
+/**
+ * @brief Create a compact line with the test plan
+ * 		Format: <name>,<bus>,<0|1 enabled>,<0|1 in ALL>;...
+ *
+ * @param buff buffer for the line
+ * @param buff_size size of the buffer
+ */
+void test_plan_report(char *buff, size_t buff_size)
+{
+	static const char *bus_names[] = {"-", "I2C", "SPI", "ADC", "GPIO"};
+	int len = 0;
+	buff[0] = 0;
+	for (uint8_t id = 0; id < TEST_NUM; id++)
+	{
+		if ((len < 0) || ((size_t)len >= buff_size))
+		{
+			return;
+		}
+		const test_entry_s *test = &test_plan.entry[id];
+		len += snprintf(&buff[len], buff_size - len, "%s%s,%s,%d,%d", id != 0 ? ";" : "", test->name,
+						bus_names[test->bus], test->run != NULL ? 1 : 0, test->in_all ? 1 : 0);
+	}
+}
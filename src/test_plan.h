@@ -0,0 +1,104 @@
+/**
+ * @file test_plan.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Compile-time registry of the hardware tests
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef TEST_PLAN_H
+#define TEST_PLAN_H
+#include <Arduino.h>
+
+/** Tests, the order is the order at boot */
+enum test_id_e
+{
+	TEST_OLED,
+	TEST_EPD,
+	TEST_I2C,
+	TEST_MARGIN,
+	TEST_GNSS,
+	TEST_FLASH,
+	TEST_SFLASH_ID,
+	TEST_SFLASH,
+	TEST_LORA,
+	TEST_BATT,
+	TEST_GPIO,
+	TEST_NUM
+};
+
+/** Bus a test uses */
+enum test_bus_e
+{
+	TEST_BUS_NONE,
+	TEST_BUS_I2C,
+	TEST_BUS_SPI,
+	TEST_BUS_ADC,
+	TEST_BUS_GPIO
+};
+
+/** Dependency mask of a test */
+#define TEST_DEP(id) (1UL << (id))
+
+/**
+ * Enable conditions, set to 0 for lean fixture builds.
+ * A disabled test, and every test that depends on it, is removed at link time.
+ */
+#ifndef TEST_ENABLE_OLED
+#define TEST_ENABLE_OLED 1
+#endif
+#ifndef TEST_ENABLE_EPD
+#define TEST_ENABLE_EPD 1
+#endif
+#ifndef TEST_ENABLE_I2C
+#define TEST_ENABLE_I2C 1
+#endif
+#ifndef TEST_ENABLE_MARGIN
+#define TEST_ENABLE_MARGIN 1
+#endif
+#ifndef TEST_ENABLE_GNSS
+#define TEST_ENABLE_GNSS 1
+#endif
+#ifndef TEST_ENABLE_FLASH
+#define TEST_ENABLE_FLASH 1
+#endif
+#ifndef TEST_ENABLE_SFLASH
+#define TEST_ENABLE_SFLASH 1
+#endif
+#ifndef TEST_ENABLE_LORA
+#define TEST_ENABLE_LORA 1
+#endif
+#ifndef TEST_ENABLE_BATT
+#define TEST_ENABLE_BATT 1
+#endif
+#ifndef TEST_ENABLE_GPIO
+#define TEST_ENABLE_GPIO 1
+#endif
+
+/**
+ * @brief Test function
+ *
+ * @param boot true if called by the boot sequence, false if called by AT+TEST
+ * @return true if the test passed
+ */
+typedef bool (*test_run_t)(bool boot);
+
+/** Entry of the test plan */
+struct test_entry_s
+{
+	const char *name; // name for AT+TEST
+	test_run_t run;	  // NULL if the test is disabled
+	uint8_t bus;	  // test_bus_e
+	uint32_t deps;	  // tests that must run before, TEST_DEP() mask
+	bool at_cmd;	  // test can be started with AT+TEST
+	bool in_all;	  // test runs at boot and with AT+TEST=ALL, false to run it only by name
+};
+
+const test_entry_s *test_plan_entry(uint8_t id);
+bool test_plan_run(uint8_t id, bool boot);
+void test_plan_boot(void);
+void test_plan_report(char *buff, size_t buff_size);
+
+#endif // TEST_PLAN_H
@@ -0,0 +1,193 @@
+/**
+ * @file trace.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Boot and test timeline trace, event buffer and USB dump
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "main.h"
+
+#if APP_TRACE > 0
+
+/** Number of events in the trace buffer, recording stops when full */
+#ifndef TRACE_BUFFER_EVENTS
+#define TRACE_BUFFER_EVENTS 1024
+#endif
+/** Max number of different tasks */
+#define TRACE_MAX_TASKS 16
+/** Max number of different span names */
+#define TRACE_MAX_NAMES 32
+/** Clock of the time stamps, FreeRTOS RTC1 runs in all sleep modes */
+#define TRACE_CLOCK_HZ 32768
+
+/** Single trace event, 8 bytes */
+struct trace_event_s
+{
+	uint32_t time;
+	uint8_t type;
+	uint8_t id;
+	uint16_t arg;
+};
+
+static trace_event_s trace_buffer[TRACE_BUFFER_EVENTS];
+static volatile uint16_t trace_count = 0;
+
+/** Known tasks, index is the task id in the events */
+static TaskHandle_t trace_tasks[TRACE_MAX_TASKS];
+static uint8_t trace_num_tasks = 0;
+
+/** Known span names, index is the name id in the events */
+static const char *trace_names[TRACE_MAX_NAMES];
+static uint8_t trace_num_names = 0;
+
+/** Unwrapping of the 24 bit RTC counter */
+static uint32_t trace_last_rtc = 0;
+static uint32_t trace_rtc_high = 0;
+
+/**
+ * @brief Add an event to the trace buffer
+ * 		Can be called from tasks, ISRs and the FreeRTOS kernel hooks.
+ *
+ * @param type event type
+ * @param id task, ISR or name id
+ * @param arg optional value
+ */
+void trace_record(uint8_t type, uint8_t id, uint16_t arg)
+{
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if (trace_count < TRACE_BUFFER_EVENTS)
+	{
+		uint32_t rtc = NRF_RTC1->COUNTER;
+		if (rtc < trace_last_rtc)
+		{
+			trace_rtc_high += 0x01000000;
+		}
+		trace_last_rtc = rtc;
+
+		trace_event_s *event = &trace_buffer[trace_count++];
+		event->time = trace_rtc_high | rtc;
+		event->type = type;
+		event->id = id;
+		event->arg = arg;
+	}
+	__set_PRIMASK(primask);
+}
+
+/**
+ * @brief FreeRTOS hook, called after the scheduler selected a new task
+ *
+ */
+void trace_task_switched_in(void)
+{
+	TaskHandle_t task = xTaskGetCurrentTaskHandle();
+	uint8_t id;
+	for (id = 0; id < trace_num_tasks; id++)
+	{
+		if (trace_tasks[id] == task)
+		{
+			break;
+		}
+	}
+	if (id == trace_num_tasks)
+	{
+		if (trace_num_tasks == TRACE_MAX_TASKS)
+		{
+			// Table full, use last entry for all other tasks
+			id = TRACE_MAX_TASKS - 1;
+		}
+		else
+		{
+			trace_tasks[trace_num_tasks++] = task;
+		}
+	}
+	trace_record(TRACE_EV_TASK_IN, id, 0);
+}
+
+/**
+ * @brief FreeRTOS hook, called when an ISR gives a semaphore or writes to a queue
+ * 		This shows when an interrupt (timer, LoRa IRQ, BLE) wakes up a task.
+ *
+ */
+void trace_isr_give(void)
+{
+	trace_record(TRACE_EV_ISR_GIVE, (uint8_t)(__get_IPSR() & 0xFF), 0);
+}
+
+/**
+ * @brief Get the id of a span name
+ *
+ * @param name name of the span, must be a string literal
+ * @return uint8_t id of the name
+ */
+uint8_t trace_name_id(const char *name)
+{
+	uint8_t id;
+	for (id = 0; id < trace_num_names; id++)
+	{
+		if (trace_names[id] == name)
+		{
+			return id;
+		}
+	}
+	taskENTER_CRITICAL();
+	if (trace_num_names < TRACE_MAX_NAMES)
+	{
+		id = trace_num_names;
+		trace_names[trace_num_names++] = name;
+	}
+	else
+	{
+		id = TRACE_MAX_NAMES - 1;
+	}
+	taskEXIT_CRITICAL();
+	return id;
+}
+
+/**
+ * @brief Dump the trace buffer over USB
+ * 		Format:
+ * 		TRACE,BEGIN,<clock Hz>,<number of events>
+ * 		TRACE,T,<id>,<task name>
+ * 		TRACE,S,<id>,<span name>
+ * 		TRACE,E,<hex records, 8 bytes each>
+ * 		TRACE,END
+ *
+ */
+void trace_dump(void)
+{
+	uint16_t count = trace_count;
+
+	Serial.printf("TRACE,BEGIN,%d,%d\n", TRACE_CLOCK_HZ, count);
+	for (uint8_t id = 0; id < trace_num_tasks; id++)
+	{
+		Serial.printf("TRACE,T,%d,%s\n", id, pcTaskGetName(trace_tasks[id]));
+	}
+	for (uint8_t id = 0; id < trace_num_names; id++)
+	{
+		Serial.printf("TRACE,S,%d,%s\n", id, trace_names[id]);
+	}
+
+	char line[16 * 8 * 2 + 1];
+	uint16_t line_pos = 0;
+	for (uint16_t idx = 0; idx < count; idx++)
+	{
+		uint8_t *raw = (uint8_t *)&trace_buffer[idx];
+		for (uint8_t byte = 0; byte < sizeof(trace_event_s); byte++)
+		{
+			line_pos += sprintf(&line[line_pos], "%02X", raw[byte]);
+		}
+		if ((line_pos == sizeof(line) - 1) || (idx == count - 1))
+		{
+			Serial.printf("TRACE,E,%s\n", line);
+			line_pos = 0;
+			Serial.flush();
+		}
+	}
+	Serial.println("TRACE,END");
+}
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file trace.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Boot and test timeline trace
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Enabled with -DAPP_TRACE=1 (see env:wiscore_rak4631_trace in platformio.ini).
+ * This header is force included into all sources of the trace build, including
+ * the FreeRTOS kernel, to install the task switch and ISR hooks. It must stay
+ * C compatible.
+ *
+ * Events are stored as 8 byte records in RAM and dumped over USB with trace_dump().
+ * tools/trace2chrome.py converts the dump into Chrome/Perfetto trace JSON.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+#include <stdint.h>
+
+#ifndef APP_TRACE
+#define APP_TRACE 0
+#endif
+
+/** Trace event types */
+#define TRACE_EV_TASK_IN 1
+#define TRACE_EV_ISR_ENTER 2
+#define TRACE_EV_ISR_EXIT 3
+#define TRACE_EV_ISR_GIVE 4
+#define TRACE_EV_SPAN_BEGIN 5
+#define TRACE_EV_SPAN_END 6
+#define TRACE_EV_MARK 7
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+	void trace_task_switched_in(void);
+	void trace_isr_give(void);
+	void trace_record(uint8_t type, uint8_t id, uint16_t arg);
+	uint8_t trace_name_id(const char *name);
+	void trace_dump(void);
+#ifdef __cplusplus
+}
+#endif
+
+#if APP_TRACE > 0
+// FreeRTOS kernel hooks
+#define traceTASK_SWITCHED_IN() trace_task_switched_in()
+#define traceQUEUE_SEND_FROM_ISR(pxQueue) trace_isr_give()
+
+/** Mark entry and exit of an application ISR, id is a free number 0-255 */
+#define TRACE_ISR_ENTER(id) trace_record(TRACE_EV_ISR_ENTER, id, 0)
+#define TRACE_ISR_EXIT(id) trace_record(TRACE_EV_ISR_EXIT, id, 0)
+/** Begin and end a named span, name must be a string literal */
+#define TRACE_BEGIN(name) trace_record(TRACE_EV_SPAN_BEGIN, trace_name_id(name), 0)
+#define TRACE_END(name) trace_record(TRACE_EV_SPAN_END, trace_name_id(name), 0)
+/** Single point in time with a value */
+#define TRACE_MARK(name, value) trace_record(TRACE_EV_MARK, trace_name_id(name), value)
+
+#ifdef __cplusplus
+/** Span that ends when leaving the scope */
+class trace_scope
+{
+public:
+	trace_scope(const char *name) : id(trace_name_id(name))
+	{
+		trace_record(TRACE_EV_SPAN_BEGIN, id, 0);
+	}
+	~trace_scope()
+	{
+		trace_record(TRACE_EV_SPAN_END, id, 0);
+	}
+
+private:
+	uint8_t id;
+};
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) trace_scope TRACE_CONCAT(_trace_scope_, __LINE__)(name)
+#endif
+#else
+#define TRACE_ISR_ENTER(id)
+#define TRACE_ISR_EXIT(id)
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#define TRACE_MARK(name, value)
+#define TRACE_SCOPE(name)
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,383 @@
+/**
+ * @file user_at_cmd.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Custom AT commands to run single tests on demand
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "main.h"
+
+/**
+ * @brief Run a single test or all tests
+ * 		AT+TEST=FLASH|SFLASH_ID|SFLASH|LORA|I2C|MARGIN|GNSS|EPD|GPIO|ALL
+ * 		Response: +TEST:<name>,<OK|FAIL>,<duration ms>
+ *
+ * @param str test name
+ * @return int 0 or error code
+ */
+static int at_exec_test(char *str)
+{
+	for (int idx = 0; str[idx] != 0; idx++)
+	{
+		str[idx] = toupper(str[idx]);
+	}
+
+	POWER_STAGE(POWER_STAGE_TEST);
+	bool run_all = strcmp(str, "ALL") == 0;
+	bool known = run_all;
+
+	// Tests run in the order of the test plan
+	for (uint8_t id = 0; id < TEST_NUM; id++)
+	{
+		const test_entry_s *test = test_plan_entry(id);
+		if (!test->at_cmd || (!run_all && (strcmp(str, test->name) != 0)))
+		{
+			continue;
+		}
+		known = true;
+		if (run_all && !test->in_all)
+		{
+			// Only run by name
+			continue;
+		}
+		if (test->run == NULL)
+		{
+			// Removed from this build
+			if (!run_all)
+			{
+				AT_PRINTF("+TEST:%s,DISABLED,0", test->name);
+			}
+			continue;
+		}
+		// No flash_reset() here, the file system stays as it is
+		time_t start = millis();
+		bool result = test_plan_run(id, false);
+		AT_PRINTF("+TEST:%s,%s,%ld", test->name, result ? "OK" : "FAIL", millis() - start);
+	}
+	POWER_STAGE(POWER_STAGE_WAIT);
+
+	if (!known)
+	{
+		return AT_ERRNO_PARA_VAL;
+	}
+	// Update OLED and EPD with the new results
+	result_publish();
+	return 0;
+}
+
+/**
+ * @brief Get the test plan of this build
+ * 		AT+PLAN?
+ * 		Response: <name>,<bus>,<0|1 enabled>,<0|1 in ALL>;...
+ *
+ * @return int 0
+ */
+static int at_query_plan(void)
+{
+	test_plan_report(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Get the results of all tests
+ * 		AT+RESULT?
+ *
+ * @return int 0
+ */
+static int at_query_result(void)
+{
+	result_serialize(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Get the I2C bus statistics
+ * 		AT+I2CSTAT?
+ * 		Response: BUS=<utilization %>;<name>,<address>,<clock kHz>,<transactions>,<busy ms>;...
+ *
+ * @return int 0
+ */
+static int at_query_i2c_stat(void)
+{
+	i2c_bus_report(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Get the I2C clock margin of all devices found
+ * 		AT+I2CMARGIN?
+ * 		Response: <address>=<max clock kHz>[A],...
+ *
+ * @return int 0
+ */
+static int at_query_i2c_margin(void)
+{
+	get_i2c_margin_line(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Get the names of all I2C devices found
+ * 		AT+I2CDEV?
+ * 		Response: <address>=<module name or ?>,...
+ *
+ * @return int 0
+ */
+static int at_query_i2c_dev(void)
+{
+	get_i2c_device_line(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Scroll the OLED back through the test log
+ * 		AT+OLEDSCROLL=<lines back>, 0 shows the newest lines
+ *
+ * @param str number of lines
+ * @return int 0 or error code
+ */
+static int at_exec_oled_scroll(char *str)
+{
+	if (!has_rak1921)
+	{
+		return AT_ERRNO_PARA_VAL;
+	}
+	for (int idx = 0; str[idx] != 0; idx++)
+	{
+		if (!isdigit(str[idx]))
+		{
+			return AT_ERRNO_PARA_VAL;
+		}
+	}
+	rak1921_scroll(strtoul(str, NULL, 10));
+	return 0;
+}
+
+/**
+ * @brief Get the OLED scroll position
+ * 		AT+OLEDSCROLL?
+ * 		Response: <lines back>,<lines in history>
+ *
+ * @return int 0
+ */
+static int at_query_oled_scroll(void)
+{
+	snprintf(g_at_query_buf, ATQUERY_SIZE, "%d,%d", rak1921_scroll_pos(), rak1921_history());
+	return 0;
+}
+
+/**
+ * @brief Get the RAM usage
+ * 		AT+RAM?
+ * 		Lines +RAM:ARENA=<owner>,<bytes> and +RAM:TASK=<name>,<free stack bytes> first
+ * 		Response: STATIC=<bytes>,HEAP=<bytes>,USED=<bytes>,FREE=<bytes>,MINFREE=<bytes>,ARENA=<bytes>
+ *
+ * @return int 0
+ */
+static int at_query_ram(void)
+{
+	char line[64];
+	const disp_claim_s *claims;
+	uint8_t num_claims = disp_arena_claims(&claims);
+	for (uint8_t idx = 0; idx < num_claims; idx++)
+	{
+		AT_PRINTF("+RAM:ARENA=%s,%d", claims[idx].owner, claims[idx].size);
+	}
+	uint8_t num_tasks = ram_report_tasks();
+	for (uint8_t idx = 0; idx < num_tasks; idx++)
+	{
+		ram_report_task_line(idx, line, sizeof(line));
+		AT_PRINTF("+RAM:%s", line);
+	}
+	ram_report_line(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Get the event queue statistics
+ * 		AT+EVQ?
+ * 		Response: DEPTH=<now>/<max>,DROP=<n>;<event>,<count>,<avg latency us>,<max latency us>;...
+ *
+ * @return int 0
+ */
+static int at_query_evq(void)
+{
+	evq_report(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Get the wake-up jitter and run time histograms of the test cycle
+ * 		AT+CYCLE?
+ * 		Response: N=<cycles>,PERIOD=<ms>,JMIN=<us>,JMAX=<us>,RMAX=<us>;JIT=<count>,...;RUN=<count>,...
+ *
+ * @return int 0
+ */
+static int at_query_cycle(void)
+{
+	cycle_report(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Clear the test cycle histograms
+ * 		AT+CYCLE
+ *
+ * @return int 0
+ */
+static int at_exec_cycle_reset(void)
+{
+	cycle_reset();
+	return 0;
+}
+
+/**
+ * @brief Get the time in each power state and the estimated charge per test stage
+ * 		AT+POWER?
+ * 		Lines +POWER:<stage>,<active ms>,<idle ms>,<sleep ms>,<tx ms>,<rx ms>,<io2 ms>,<oled ms>,<uAh> first
+ * 		Response: CYCLES=<n>,MAH_CYCLE=<mAh>,MAH_TOTAL=<mAh>
+ *
+ * @return int 0
+ */
+static int at_query_power(void)
+{
+#if APP_POWER > 0
+	char line[96];
+	for (uint8_t stage = 0; stage < POWER_NUM_STAGES; stage++)
+	{
+		power_report_stage(stage, line, sizeof(line));
+		AT_PRINTF("+POWER:%s", line);
+	}
+#endif
+	power_report(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Get the fast boot status and the time from reset to the first test
+ * 		AT+BOOT?
+ * 		Response: FAST_BOOT=<0|1>,FIRST_TEST=<ms after reset>,BUFFERED=<bytes>,DROPPED=<bytes>
+ *
+ * @return int 0
+ */
+static int at_query_boot(void)
+{
+	boot_log_report(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Get the soak log status
+ * 		AT+SOAK?
+ * 		Response: SOAK=<0|1>,SAMPLES=<n since boot>,BYTES=<in flash>,BUFFERED=<samples>,ERRORS=<n>
+ *
+ * @return int 0
+ */
+static int at_query_soak(void)
+{
+	soak_report(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Delete the soak log
+ * 		AT+SOAK=0
+ *
+ * @param str 0
+ * @return int 0 or error code
+ */
+static int at_exec_soak(char *str)
+{
+	if (strcmp(str, "0") != 0)
+	{
+		return AT_ERRNO_PARA_VAL;
+	}
+	soak_clear();
+	return 0;
+}
+
+/**
+ * @brief Export the soak log
+ * 		AT+SOAKDUMP
+ * 		Lines +SOAKDUMP:<hex> and +SOAKDUMP:END,<bytes>,<CRC-32>, decode with tools/soak_decode.py
+ *
+ * @return int 0
+ */
+static int at_exec_soak_dump(void)
+{
+	soak_dump();
+	return 0;
+}
+
+/**
+ * @brief Render the snapshot scenario and report output CRC, cycles and I2C use per path
+ * 		AT+SNAP
+ * 		Lines +SNAP:<path>,<CRC-32>,<cycles>,<I2C transactions>,<I2C bus us> or +SNAP:<path>,NA
+ *
+ * @return int 0
+ */
+static int at_exec_snap(void)
+{
+	snapshot_run();
+	return 0;
+}
+
+/**
+ * @brief Get the result of the SPI flash test
+ * 		AT+SFLASH?
+ * 		Response: ID=<JEDEC ID>,SIZE=<kB>,ERASE=<MB/s>,PROG=<MB/s>,READ=<MB/s>,CRC=<OK|FAIL> or NONE
+ *
+ * @return int 0
+ */
+static int at_query_sflash(void)
+{
+	rak15001_report(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief Get the result of the last IO slot loopback test
+ * 		AT+GPIO?
+ * 		Response: TIME=<us>;<pin>=<OK|OPEN|SHORT|HIGH|LOW>,<delay ns>[,<shorted pins>];...
+ *
+ * @return int 0
+ */
+static int at_query_gpio(void)
+{
+	gpio_loop_report(g_at_query_buf, ATQUERY_SIZE);
+	return 0;
+}
+
+/**
+ * @brief List of the tester AT commands
+ *
+ */
+atcmd_t g_user_at_cmd_list_tester[] = {
+	/*|    CMD    |     AT+CMD?      |    AT+CMD=?    |  AT+CMD=value |  AT+CMD  | Permissions |*/
+	{"+TEST", "Run test FLASH|SFLASH_ID|SFLASH|LORA|I2C|MARGIN|GNSS|EPD|GPIO|ALL", NULL, at_exec_test, NULL, "W"},
+	{"+RESULT", "Get test results", at_query_result, NULL, NULL, "R"},
+	{"+PLAN", "Get the test plan of this build", at_query_plan, NULL, NULL, "R"},
+	{"+I2CSTAT", "Get I2C bus statistics", at_query_i2c_stat, NULL, NULL, "R"},
+	{"+I2CDEV", "Get names of the I2C devices found", at_query_i2c_dev, NULL, NULL, "R"},
+	{"+OLEDSCROLL", "Scroll OLED log back n lines", at_query_oled_scroll, at_exec_oled_scroll, NULL, "RW"},
+	{"+I2CMARGIN", "Get I2C clock margin per device", at_query_i2c_margin, NULL, NULL, "R"},
+	{"+RAM", "Get RAM usage", at_query_ram, NULL, NULL, "R"},
+	{"+EVQ", "Get event queue statistics", at_query_evq, NULL, NULL, "R"},
+	{"+BOOT", "Get fast boot status and time to first test", at_query_boot, NULL, NULL, "R"},
+	{"+POWER", "Get power state times and charge per test stage", at_query_power, NULL, NULL, "R"},
+	{"+CYCLE", "Get/clear test cycle jitter and run time histograms", at_query_cycle, NULL, at_exec_cycle_reset, "RW"},
+	{"+SOAK", "Get soak log status, =0 to delete the log", at_query_soak, at_exec_soak, NULL, "RW"},
+	{"+SOAKDUMP", "Export the soak log as hex lines", NULL, NULL, at_exec_soak_dump, "R"},
+	{"+SNAP", "Render snapshot, output CRC, cycles and I2C use per path", NULL, NULL, at_exec_snap, "R"},
+	{"+SFLASH", "Get SPI flash ID and throughput", at_query_sflash, NULL, NULL, "R"},
+	{"+GPIO", "Get IO slot loopback result", at_query_gpio, NULL, NULL, "R"},
+};
+
+/** Pointer to the user AT command list */
+atcmd_t *g_user_at_cmd_list = g_user_at_cmd_list_tester;
+
+/** Number of user defined AT commands */
+uint8_t g_user_at_cmd_num = sizeof(g_user_at_cmd_list_tester) / sizeof(atcmd_t);
@@ -0,0 +1,108 @@
+/**
+ * @file ble_loopback.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Loopback stand-in for the BLE UART link of the throughput test
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Behaves like the BLE UART as seen by the receiver: writes are split into
+ * notifications of at most mtu - 3 bytes, the receiver reads a byte stream
+ * in chunks of any size. Single notifications can be dropped or get a byte
+ * flipped to test the loss and corruption counters.
+ */
+#ifndef BLE_LOOPBACK_H
+#define BLE_LOOPBACK_H
+#include <stdint.h>
+#include <string.h>
+
+/** Size of the receive FIFO, large enough for a few frames */
+#define BLE_LOOPBACK_FIFO 2048
+
+struct ble_loopback_s
+{
+	/** Payload size of a notification (ATT MTU - 3) */
+	uint16_t payload;
+	/** Index of the next notification */
+	uint32_t notify_idx;
+	/** Notification to drop, -1 for none */
+	int32_t drop_idx;
+	/** Notification with a flipped byte, -1 for none */
+	int32_t corrupt_idx;
+	/** Offset of the flipped byte in that notification */
+	uint16_t corrupt_offset;
+	uint8_t fifo[BLE_LOOPBACK_FIFO];
+	uint32_t head;
+	uint32_t tail;
+};
+
+/**
+ * @brief Reset the link
+ *
+ * @param link loopback state
+ * @param mtu negotiated ATT MTU
+ */
+inline void ble_loopback_init(ble_loopback_s *link, uint16_t mtu)
+{
+	memset(link, 0, sizeof(ble_loopback_s));
+	link->payload = mtu - 3;
+	link->drop_idx = -1;
+	link->corrupt_idx = -1;
+}
+
+/**
+ * @brief Send data, like g_ble_uart.write()
+ *
+ * @param link loopback state
+ * @param data data to send
+ * @param len number of bytes
+ * @return uint16_t number of bytes accepted, less if the FIFO is full
+ */
+inline uint16_t ble_loopback_write(ble_loopback_s *link, const uint8_t *data, uint16_t len)
+{
+	uint16_t sent = 0;
+	while (sent < len)
+	{
+		uint16_t chunk = len - sent > link->payload ? link->payload : len - sent;
+		if (BLE_LOOPBACK_FIFO - (link->head - link->tail) < chunk)
+		{
+			break;
+		}
+		if ((int32_t)link->notify_idx != link->drop_idx)
+		{
+			for (uint16_t idx = 0; idx < chunk; idx++)
+			{
+				uint8_t value = data[sent + idx];
+				if (((int32_t)link->notify_idx == link->corrupt_idx) && (idx == link->corrupt_offset))
+				{
+					value ^= 0x5A;
+				}
+				link->fifo[link->head++ % BLE_LOOPBACK_FIFO] = value;
+			}
+		}
+		link->notify_idx++;
+		sent += chunk;
+	}
+	return sent;
+}
+
+/**
+ * @brief Receive data, like g_ble_uart.read()
+ *
+ * @param link loopback state
+ * @param data buffer for the data
+ * @param len size of the buffer
+ * @return uint16_t number of bytes read
+ */
+inline uint16_t ble_loopback_read(ble_loopback_s *link, uint8_t *data, uint16_t len)
+{
+	uint16_t read_len = 0;
+	while ((read_len < len) && (link->tail != link->head))
+	{
+		data[read_len++] = link->fifo[link->tail++ % BLE_LOOPBACK_FIFO];
+	}
+	return read_len;
+}
+
+#endif // BLE_LOOPBACK_H
@@ -0,0 +1,51 @@
+/**
+ * @file host_test.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Minimal check macros for the host tests
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+#include <stdio.h>
+
+/** Number of failed checks, the exit code of a test program */
+extern int host_test_failures;
+
+/** Check a condition, print file and line if it fails */
+#define CHECK(cond)                                                        \
+	do                                                                     \
+	{                                                                      \
+		if (!(cond))                                                       \
+		{                                                                  \
+			printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+			host_test_failures++;                                          \
+		}                                                                  \
+	} while (0)
+
+/** Check two integers for equality, print both values if they differ */
+#define CHECK_EQ(a, b)                                                                        \
+	do                                                                                        \
+	{                                                                                         \
+		long long check_a = (long long)(a);                                                   \
+		long long check_b = (long long)(b);                                                   \
+		if (check_a != check_b)                                                               \
+		{                                                                                     \
+			printf("%s:%d: %s == %s failed, %lld != %lld\n", __FILE__, __LINE__, #a, #b, check_a, \
+				   check_b);                                                                  \
+			host_test_failures++;                                                             \
+		}                                                                                     \
+	} while (0)
+
+/** Run a test function and print its name */
+#define RUN_TEST(test)          \
+	do                          \
+	{                           \
+		printf("%s\n", #test);  \
+		test();                 \
+	} while (0)
+
+#endif // HOST_TEST_H
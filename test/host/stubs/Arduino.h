@@ -0,0 +1,95 @@
+/**
+ * @file Arduino.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Host stand-in of the Arduino core for the host tests
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Time is simulated: millis() and micros() only move with delay() and with
+ * the modeled bus transfers of the Wire and SPI stand-ins, so every run
+ * gives the same times.
+ */
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <algorithm>
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLDOWN 3
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+
+/** WisBlock pins of the RAK4631 */
+#define WB_IO1 17
+#define WB_IO2 34
+#define WB_IO3 21
+#define WB_IO4 4
+#define WB_IO5 9
+#define WB_IO6 10
+#define PIN_WIRE_SDA 13
+#define PIN_WIRE_SCL 14
+#define SS 26
+
+using std::max;
+using std::min;
+
+/** Simulated time in us */
+extern uint64_t host_time_us;
+
+/**
+ * @brief Advance the simulated time
+ *
+ * @param us time in us
+ */
+inline void host_advance_us(uint64_t us)
+{
+	host_time_us += us;
+}
+
+inline unsigned long millis(void)
+{
+	return (unsigned long)(uint32_t)(host_time_us / 1000);
+}
+
+inline unsigned long micros(void)
+{
+	return (unsigned long)(uint32_t)host_time_us;
+}
+
+inline void delay(uint32_t ms)
+{
+	host_advance_us((uint64_t)ms * 1000);
+}
+
+inline void pinMode(uint32_t pin, uint32_t mode)
+{
+	(void)pin;
+	(void)mode;
+}
+
+inline void digitalWrite(uint32_t pin, uint32_t value)
+{
+	(void)pin;
+	(void)value;
+}
+
+inline int digitalRead(uint32_t pin)
+{
+	(void)pin;
+	return HIGH;
+}
+
+#endif // HOST_ARDUINO_H
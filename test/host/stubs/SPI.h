@@ -0,0 +1,89 @@
+/**
+ * @file SPI.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Host stand-in of the SPI bus that counts bytes and bus time
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The bus time is 8 clocks per byte at the clock of the last transaction
+ * and moves the simulated time. Reads return 0xFF (MISO pulled up).
+ */
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+#include <Arduino.h>
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+class SPISettings
+{
+public:
+	SPISettings(uint32_t clock = 4000000, uint8_t order = MSBFIRST, uint8_t mode = SPI_MODE0)
+		: clock(clock)
+	{
+		(void)order;
+		(void)mode;
+	}
+	uint32_t clock;
+};
+
+class SPIClass
+{
+public:
+	/** Traffic since the start */
+	uint32_t transactions = 0;
+	uint32_t bytes = 0;
+	uint64_t bus_us = 0;
+
+	void begin(void)
+	{
+	}
+	void end(void)
+	{
+	}
+	void beginTransaction(const SPISettings &settings)
+	{
+		clock_hz = settings.clock;
+		transactions++;
+	}
+	void endTransaction(void)
+	{
+	}
+	uint8_t transfer(uint8_t data)
+	{
+		(void)data;
+		count(1);
+		return 0xFF;
+	}
+	void transfer(const void *tx, void *rx, size_t len)
+	{
+		(void)tx;
+		if (rx != NULL)
+		{
+			memset(rx, 0xFF, len);
+		}
+		count(len);
+	}
+	void transfer(void *data, size_t len)
+	{
+		memset(data, 0xFF, len);
+		count(len);
+	}
+
+private:
+	uint32_t clock_hz = 4000000;
+
+	void count(size_t len)
+	{
+		uint64_t us = (uint64_t)len * 8 * 1000000 / clock_hz;
+		bytes += len;
+		bus_us += us;
+		host_advance_us(us);
+	}
+};
+
+extern SPIClass SPI;
+
+#endif // HOST_SPI_H
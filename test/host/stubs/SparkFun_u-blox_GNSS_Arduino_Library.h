@@ -0,0 +1,193 @@
+/**
+ * @file SparkFun_u-blox_GNSS_Arduino_Library.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Host stand-in of the u-blox GNSS library that plays back a list of navigation solutions
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * With autoPVT the library reads one UBX-NAV-PVT message (100 bytes) per
+ * navigation solution: the available byte count from register 0xFD, then
+ * the message in reads of 32 bytes. The stand-in does this I2C traffic on
+ * the first getter call after a new solution and returns the values of the
+ * current entry of the script. A new solution is read when the simulated
+ * time moved by at least the navigation period since the last one, after
+ * the end of the script the last entry repeats.
+ */
+#ifndef HOST_UBLOX_GNSS_H
+#define HOST_UBLOX_GNSS_H
+#include <Arduino.h>
+#include <Wire.h>
+
+#define COM_TYPE_UBX 0x01
+
+enum sfe_ublox_gnss_ids_e
+{
+	SFE_UBLOX_GNSS_ID_GPS,
+	SFE_UBLOX_GNSS_ID_SBAS,
+	SFE_UBLOX_GNSS_ID_GALILEO,
+	SFE_UBLOX_GNSS_ID_BEIDOU,
+	SFE_UBLOX_GNSS_ID_IMES,
+	SFE_UBLOX_GNSS_ID_QZSS,
+	SFE_UBLOX_GNSS_ID_GLONASS
+};
+
+/** One navigation solution of the script */
+struct host_pvt_s
+{
+	int32_t latitude;  // deg x 1e7
+	int32_t longitude; // deg x 1e7
+	int32_t altitude;  // mm
+	uint16_t hdop;	   // x 100
+	uint8_t siv;	   // satellites used
+	uint8_t fix_type;  // 0 none, 2 2D, 3 3D
+};
+
+/** Size of the UBX-NAV-PVT message with header and checksum */
+#define HOST_PVT_SIZE 100
+/** Max read of the library in one I2C transaction */
+#define HOST_UBLOX_I2C_CHUNK 32
+
+class SFE_UBLOX_GNSS
+{
+public:
+	/** Address of the module */
+	uint8_t address = 0x42;
+
+	/**
+	 * @brief Set the list of solutions, the last one repeats
+	 *
+	 * @param pvt solutions
+	 * @param num number of solutions
+	 */
+	void host_script(const host_pvt_s *pvt, uint8_t num)
+	{
+		script = pvt;
+		script_len = num;
+		script_pos = 0;
+		fresh = true;
+		last_epoch_us = host_time_us;
+	}
+
+	bool begin(void)
+	{
+		return Wire.present[address];
+	}
+	bool setI2COutput(uint8_t com_type)
+	{
+		(void)com_type;
+		return true;
+	}
+	bool enableGNSS(bool enable, sfe_ublox_gnss_ids_e id)
+	{
+		(void)enable;
+		(void)id;
+		return true;
+	}
+	bool setNavigationFrequency(uint8_t rate)
+	{
+		period_us = 1000000 / rate;
+		return true;
+	}
+	bool setAutoPVT(bool enable, bool implicit)
+	{
+		(void)enable;
+		(void)implicit;
+		return true;
+	}
+	bool saveConfiguration(void)
+	{
+		return true;
+	}
+	bool getGnssFixOk(void)
+	{
+		return pvt()->fix_type >= 2;
+	}
+
+	int32_t getLatitude(void)
+	{
+		return pvt()->latitude;
+	}
+	int32_t getLongitude(void)
+	{
+		return pvt()->longitude;
+	}
+	int32_t getAltitude(void)
+	{
+		return pvt()->altitude;
+	}
+	uint16_t getHorizontalDOP(void)
+	{
+		return pvt()->hdop;
+	}
+	uint8_t getSIV(void)
+	{
+		return pvt()->siv;
+	}
+	uint8_t getFixType(void)
+	{
+		return pvt()->fix_type;
+	}
+
+private:
+	const host_pvt_s *script = NULL;
+	uint8_t script_len = 0;
+	uint8_t script_pos = 0;
+	bool fresh = false;
+	uint64_t last_epoch_us = 0;
+	uint32_t period_us = 1000000;
+
+	/**
+	 * @brief Get the current solution, read a new one if one is due
+	 *
+	 * @return const host_pvt_s* solution
+	 */
+	const host_pvt_s *pvt(void)
+	{
+		static const host_pvt_s no_fix = {0, 0, 0, 9999, 0, 0};
+		if (script_len == 0)
+		{
+			return &no_fix;
+		}
+		if (!fresh && (host_time_us - last_epoch_us >= period_us))
+		{
+			if (script_pos + 1 < script_len)
+			{
+				script_pos++;
+			}
+			fresh = true;
+		}
+		if (fresh)
+		{
+			fresh = false;
+			last_epoch_us = host_time_us;
+			read_pvt();
+		}
+		return &script[script_pos];
+	}
+
+	/**
+	 * @brief I2C traffic of reading one UBX-NAV-PVT message
+	 *
+	 */
+	void read_pvt(void)
+	{
+		Wire.beginTransmission(address);
+		Wire.write(0xFD);
+		Wire.endTransmission(false);
+		Wire.requestFrom(address, (size_t)2);
+		for (uint16_t left = HOST_PVT_SIZE; left != 0;)
+		{
+			uint16_t chunk = left > HOST_UBLOX_I2C_CHUNK ? HOST_UBLOX_I2C_CHUNK : left;
+			Wire.requestFrom(address, (size_t)chunk);
+			while (Wire.available())
+			{
+				Wire.read();
+			}
+			left -= chunk;
+		}
+	}
+};
+
+#endif // HOST_UBLOX_GNSS_H
@@ -0,0 +1,123 @@
+/**
+ * @file Wire.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Host stand-in of the I2C bus that counts transactions, bytes and bus time
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Every byte on the bus (address byte included) is counted per device.
+ * The bus time is modeled as 9 clocks per byte plus start and stop at the
+ * clock set with setClock() and moves the simulated time.
+ * Devices answer if they are marked present, reads return 0.
+ */
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+#include <Arduino.h>
+
+/** Traffic of one device or of the whole bus */
+struct host_bus_stat_s
+{
+	uint32_t transactions;
+	uint32_t bytes;
+	uint64_t bus_us;
+};
+
+class TwoWire
+{
+public:
+	/** Traffic per 7 bit address */
+	host_bus_stat_s device[128];
+	/** Devices that ACK their address */
+	bool present[128];
+
+	void begin(void)
+	{
+	}
+	void setClock(uint32_t clock)
+	{
+		clock_hz = clock;
+	}
+	void beginTransmission(uint8_t address)
+	{
+		tx_address = address;
+		tx_len = 0;
+	}
+	size_t write(uint8_t data)
+	{
+		(void)data;
+		tx_len++;
+		return 1;
+	}
+	size_t write(const uint8_t *data, size_t len)
+	{
+		(void)data;
+		tx_len += len;
+		return len;
+	}
+	uint8_t endTransmission(bool stop = true)
+	{
+		(void)stop;
+		transfer(tx_address, 1 + tx_len);
+		return present[tx_address & 0x7f] ? 0 : 2;
+	}
+	uint8_t requestFrom(uint8_t address, size_t len, bool stop = true)
+	{
+		(void)stop;
+		bool ack = present[address & 0x7f];
+		transfer(address, ack ? 1 + len : 1);
+		rx_left = ack ? len : 0;
+		return rx_left;
+	}
+	int available(void)
+	{
+		return rx_left;
+	}
+	int read(void)
+	{
+		if (rx_left == 0)
+		{
+			return -1;
+		}
+		rx_left--;
+		return 0;
+	}
+
+	/**
+	 * @brief Sum of the traffic of all devices
+	 *
+	 * @return host_bus_stat_s traffic
+	 */
+	host_bus_stat_s total(void)
+	{
+		host_bus_stat_s sum = {0, 0, 0};
+		for (int idx = 0; idx < 128; idx++)
+		{
+			sum.transactions += device[idx].transactions;
+			sum.bytes += device[idx].bytes;
+			sum.bus_us += device[idx].bus_us;
+		}
+		return sum;
+	}
+
+private:
+	uint32_t clock_hz = 100000;
+	uint8_t tx_address = 0;
+	size_t tx_len = 0;
+	size_t rx_left = 0;
+
+	void transfer(uint8_t address, size_t bytes)
+	{
+		uint64_t bus_us = ((uint64_t)bytes * 9 + 2) * 1000000 / clock_hz;
+		host_bus_stat_s *stat = &device[address & 0x7f];
+		stat->transactions++;
+		stat->bytes += bytes;
+		stat->bus_us += bus_us;
+		host_advance_us(bus_us);
+	}
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
@@ -0,0 +1,69 @@
+/**
+ * @file WisBlock-API-V2.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Host stand-in of the WisBlock API and FreeRTOS parts used by the display and GNSS code
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * The host tests run in a single thread, the semaphores always succeed.
+ * Log output (MYLOG) is collected in host_log, so a test can check it.
+ */
+#ifndef HOST_WISBLOCK_API_H
+#define HOST_WISBLOCK_API_H
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+
+// FreeRTOS
+typedef void *SemaphoreHandle_t;
+typedef void *TaskHandle_t;
+typedef int BaseType_t;
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY 0xffffffff
+
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+	static int mutex;
+	return &mutex;
+}
+
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, uint32_t wait)
+{
+	(void)sem;
+	(void)wait;
+	return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem)
+{
+	(void)sem;
+	return pdTRUE;
+}
+
+/** Collected log output */
+#define HOST_LOG_SIZE 8192
+extern char host_log[HOST_LOG_SIZE];
+extern size_t host_log_len;
+
+void host_log_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+void host_log_clear(void);
+
+#define PRINTF(...) host_log_printf(__VA_ARGS__)
+
+/** BLE UART, never connected on the host */
+class BLEUart
+{
+public:
+	int printf(const char *fmt, ...)
+	{
+		(void)fmt;
+		return 0;
+	}
+};
+extern BLEUart g_ble_uart;
+extern bool g_ble_uart_is_connected;
+
+#endif // HOST_WISBLOCK_API_H
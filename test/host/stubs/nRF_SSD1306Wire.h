@@ -0,0 +1,274 @@
+/**
+ * @file nRF_SSD1306Wire.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Host stand-in of the SSD1306 OLED driver
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Framebuffer layout, drawing primitives and the double buffered display()
+ * follow the OLED library: only the bounding box of the changed bytes is
+ * sent, as 16 byte data packets after the column and page address commands.
+ * So the I2C traffic counted by the Wire stand-in matches the real driver.
+ * Text uses a synthetic 6 x 8 font instead of ArialMT, each character gets
+ * its own column pattern, so text, position and clipping changes show up
+ * in the framebuffer CRC.
+ */
+#ifndef HOST_SSD1306WIRE_H
+#define HOST_SSD1306WIRE_H
+#include <Arduino.h>
+#include <Wire.h>
+
+enum OLEDDISPLAY_GEOMETRY
+{
+	GEOMETRY_128_64 = 0
+};
+
+enum OLEDDISPLAY_COLOR
+{
+	BLACK = 0,
+	WHITE = 1,
+	INVERSE = 2
+};
+
+enum OLEDDISPLAY_TEXT_ALIGNMENT
+{
+	TEXT_ALIGN_LEFT = 0
+};
+
+extern const uint8_t ArialMT_Plain_10[];
+
+/** SSD1306 commands used by display() */
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+#define SSD1306_SETCONTRAST 0x81
+
+/** Width of a character of the synthetic font */
+#define HOST_OLED_CHAR_WIDTH 6
+
+class SSD1306Wire
+{
+public:
+	static const int width = 128;
+	static const int height = 64;
+	uint8_t buffer[width * height / 8];
+
+	SSD1306Wire(uint8_t address, int sda, int scl, OLEDDISPLAY_GEOMETRY geometry, TwoWire *wire)
+		: address(address), wire(wire)
+	{
+		(void)sda;
+		(void)scl;
+		(void)geometry;
+		memset(buffer, 0, sizeof(buffer));
+		memset(buffer_back, 0, sizeof(buffer_back));
+	}
+
+	void setI2cAutoInit(bool auto_init)
+	{
+		(void)auto_init;
+	}
+	bool init(void)
+	{
+		memset(buffer, 0, sizeof(buffer));
+		// Force a full frame on the first display()
+		memset(buffer_back, 0xFF, sizeof(buffer_back));
+		return true;
+	}
+	void displayOn(void)
+	{
+		send_command(SSD1306_DISPLAYON);
+	}
+	void displayOff(void)
+	{
+		send_command(SSD1306_DISPLAYOFF);
+	}
+	void flipScreenVertically(void)
+	{
+		send_command(0xA1);
+		send_command(0xC8);
+	}
+	void setContrast(uint8_t contrast)
+	{
+		send_command(SSD1306_SETCONTRAST);
+		send_command(contrast);
+	}
+	void clear(void)
+	{
+		memset(buffer, 0, sizeof(buffer));
+	}
+	void setFont(const uint8_t *font)
+	{
+		(void)font;
+	}
+	void setColor(OLEDDISPLAY_COLOR new_color)
+	{
+		color = new_color;
+	}
+	void setTextAlignment(OLEDDISPLAY_TEXT_ALIGNMENT alignment)
+	{
+		(void)alignment;
+	}
+
+	void setPixel(int16_t x, int16_t y)
+	{
+		if ((x < 0) || (x >= width) || (y < 0) || (y >= height))
+		{
+			return;
+		}
+		uint8_t *dest = &buffer[x + (y / 8) * width];
+		uint8_t bit = 1 << (y & 7);
+		if (color == WHITE)
+		{
+			*dest |= bit;
+		}
+		else if (color == BLACK)
+		{
+			*dest &= ~bit;
+		}
+		else
+		{
+			*dest ^= bit;
+		}
+	}
+
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h)
+	{
+		for (int16_t col = x; col < x + w; col++)
+		{
+			for (int16_t row = y; row < y + h; row++)
+			{
+				setPixel(col, row);
+			}
+		}
+	}
+
+	void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+	{
+		// Bresenham, both end points included
+		int16_t dx = abs(x1 - x0);
+		int16_t dy = -abs(y1 - y0);
+		int16_t sx = x0 < x1 ? 1 : -1;
+		int16_t sy = y0 < y1 ? 1 : -1;
+		int16_t err = dx + dy;
+		while (true)
+		{
+			setPixel(x0, y0);
+			if ((x0 == x1) && (y0 == y1))
+			{
+				break;
+			}
+			int16_t err2 = 2 * err;
+			if (err2 >= dy)
+			{
+				err += dy;
+				x0 += sx;
+			}
+			if (err2 <= dx)
+			{
+				err += dx;
+				y0 += sy;
+			}
+		}
+	}
+
+	uint16_t drawString(int16_t x, int16_t y, const char *text)
+	{
+		int16_t start = x;
+		for (; *text != 0; text++, x += HOST_OLED_CHAR_WIDTH)
+		{
+			uint8_t c = (uint8_t)*text;
+			if (c == ' ')
+			{
+				continue;
+			}
+			for (uint8_t col = 0; col < HOST_OLED_CHAR_WIDTH - 1; col++)
+			{
+				uint8_t bits = (uint8_t)((c * 37 + col * 73) ^ (c >> 2)) | 0x01;
+				for (uint8_t row = 0; row < 8; row++)
+				{
+					if (bits & (1 << row))
+					{
+						setPixel(x + col, y + 1 + row);
+					}
+				}
+			}
+		}
+		return x - start;
+	}
+
+	/**
+	 * @brief Send the changed part of the framebuffer
+	 *
+	 */
+	void display(void)
+	{
+		uint8_t min_x = 0xFF, max_x = 0, min_page = 0xFF, max_page = 0;
+		for (uint8_t page = 0; page < height / 8; page++)
+		{
+			for (uint8_t x = 0; x < width; x++)
+			{
+				uint16_t idx = x + page * width;
+				if (buffer[idx] != buffer_back[idx])
+				{
+					min_x = min(min_x, x);
+					max_x = max(max_x, x);
+					min_page = min(min_page, page);
+					max_page = max(max_page, page);
+				}
+				buffer_back[idx] = buffer[idx];
+			}
+		}
+		if (min_page == 0xFF)
+		{
+			return;
+		}
+		send_command(SSD1306_COLUMNADDR);
+		send_command(min_x);
+		send_command(max_x);
+		send_command(SSD1306_PAGEADDR);
+		send_command(min_page);
+		send_command(max_page);
+
+		uint8_t packet = 0;
+		for (uint8_t page = min_page; page <= max_page; page++)
+		{
+			for (uint8_t x = min_x; x <= max_x; x++)
+			{
+				if (packet == 0)
+				{
+					wire->beginTransmission(address);
+					wire->write(0x40);
+				}
+				wire->write(buffer[x + page * width]);
+				if (++packet == 16)
+				{
+					wire->endTransmission();
+					packet = 0;
+				}
+			}
+		}
+		if (packet != 0)
+		{
+			wire->endTransmission();
+		}
+	}
+
+private:
+	uint8_t address;
+	TwoWire *wire;
+	OLEDDISPLAY_COLOR color = WHITE;
+	uint8_t buffer_back[width * height / 8];
+
+	void send_command(uint8_t command)
+	{
+		wire->beginTransmission(address);
+		wire->write(0x80);
+		wire->write(command);
+		wire->endTransmission();
+	}
+};
+
+#endif // HOST_SSD1306WIRE_H
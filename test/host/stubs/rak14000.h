@@ -0,0 +1,239 @@
+/**
+ * @file rak14000.h
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Host stand-in of the RAK14000 EPD library (Paint, fonts, panel driver)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Paint follows the Waveshare epdpaint code of the library: width padded to
+ * 8 pixel, rotation in DrawPixel(), fonts as rows of bytes, MSB left, so the
+ * layout probe of the text blitter sees the same buffer as on the target.
+ * The font tables are synthetic (each glyph has its own pattern), the panel
+ * driver only sends the command and data bytes over the SPI stand-in and
+ * models the busy time of a full refresh.
+ */
+#ifndef HOST_RAK14000_H
+#define HOST_RAK14000_H
+#include <Arduino.h>
+#include <SPI.h>
+
+#define COLORED 0
+#define UNCOLORED 1
+
+#define ROTATE_0 0
+#define ROTATE_90 1
+#define ROTATE_180 2
+#define ROTATE_270 3
+
+#define FULL 0
+#define PART 1
+
+/** Time the panel is busy with a full refresh in ms */
+#define HOST_EPD_REFRESH_MS 2000
+/** SPI clock of the panel */
+#define HOST_EPD_SPI_CLOCK 4000000
+
+typedef struct _tFont
+{
+	const uint8_t *table;
+	uint16_t Width;
+	uint16_t Height;
+} sFONT;
+
+extern sFONT Font12;
+extern sFONT Font20;
+
+class Paint
+{
+public:
+	Paint(unsigned char *image, int width, int height)
+		: image(image), width(width % 8 ? width + 8 - (width % 8) : width), height(height), rotate(ROTATE_0)
+	{
+	}
+
+	void Clear(int colored)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			for (int y = 0; y < height; y++)
+			{
+				DrawAbsolutePixel(x, y, colored);
+			}
+		}
+	}
+	int GetWidth(void)
+	{
+		return width;
+	}
+	int GetHeight(void)
+	{
+		return height;
+	}
+	void SetRotate(int new_rotate)
+	{
+		rotate = new_rotate;
+	}
+
+	void DrawAbsolutePixel(int x, int y, int colored)
+	{
+		if ((x < 0) || (x >= width) || (y < 0) || (y >= height))
+		{
+			return;
+		}
+		if (colored)
+		{
+			image[(x + y * width) / 8] |= 0x80 >> (x % 8);
+		}
+		else
+		{
+			image[(x + y * width) / 8] &= ~(0x80 >> (x % 8));
+		}
+	}
+
+	void DrawPixel(int x, int y, int colored)
+	{
+		int point_temp;
+		if ((rotate == ROTATE_0) || (rotate == ROTATE_180))
+		{
+			if ((x < 0) || (x >= width) || (y < 0) || (y >= height))
+			{
+				return;
+			}
+			if (rotate == ROTATE_180)
+			{
+				x = width - x;
+				y = height - y;
+			}
+		}
+		else
+		{
+			if ((x < 0) || (x >= height) || (y < 0) || (y >= width))
+			{
+				return;
+			}
+			point_temp = x;
+			if (rotate == ROTATE_90)
+			{
+				x = width - y;
+				y = point_temp;
+			}
+			else
+			{
+				x = y;
+				y = height - point_temp;
+			}
+		}
+		DrawAbsolutePixel(x, y, colored);
+	}
+
+	void DrawCharAt(int x, int y, char ascii_char, sFONT *font, int colored)
+	{
+		int char_offset = (ascii_char - ' ') * font->Height * (font->Width / 8 + (font->Width % 8 ? 1 : 0));
+		const unsigned char *ptr = &font->table[char_offset];
+		for (int j = 0; j < font->Height; j++)
+		{
+			for (int i = 0; i < font->Width; i++)
+			{
+				if (pgm_read_byte(ptr) & (0x80 >> (i % 8)))
+				{
+					DrawPixel(x + i, y + j, colored);
+				}
+				if (i % 8 == 7)
+				{
+					ptr++;
+				}
+			}
+			if (font->Width % 8 != 0)
+			{
+				ptr++;
+			}
+		}
+	}
+
+	void DrawStringAt(int x, int y, const char *text, sFONT *font, int colored)
+	{
+		for (int refcolumn = x; *text != 0; text++, refcolumn += font->Width)
+		{
+			DrawCharAt(refcolumn, y, *text, font, colored);
+		}
+	}
+
+	void DrawFilledRectangle(int x0, int y0, int x1, int y1, int colored)
+	{
+		for (int x = min(x0, x1); x <= max(x0, x1); x++)
+		{
+			for (int y = min(y0, y1); y <= max(y0, y1); y++)
+			{
+				DrawPixel(x, y, colored);
+			}
+		}
+	}
+
+	void drawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h)
+	{
+		int16_t byte_width = (w + 7) / 8;
+		for (int16_t j = 0; j < h; j++)
+		{
+			for (int16_t i = 0; i < w; i++)
+			{
+				if (pgm_read_byte(&bitmap[j * byte_width + i / 8]) & (0x80 >> (i & 7)))
+				{
+					DrawPixel(x + i, y + j, COLORED);
+				}
+			}
+		}
+	}
+
+private:
+	unsigned char *image;
+	int width;
+	int height;
+	int rotate;
+};
+
+class EPD_213_BW
+{
+public:
+	int Init(int mode)
+	{
+		(void)mode;
+		// Reset, driver output, data entry mode, RAM window, border, LUT
+		send(0x12, 0);
+		send(0x01, 3);
+		send(0x11, 1);
+		send(0x44, 2);
+		send(0x45, 4);
+		send(0x3C, 1);
+		send(0x4E, 1);
+		send(0x4F, 2);
+		return 0;
+	}
+	void Display(const unsigned char *image)
+	{
+		(void)image;
+		send(0x24, 4000);
+		send(0x22, 1);
+		send(0x20, 0);
+		delay(HOST_EPD_REFRESH_MS);
+	}
+	void Clear(void)
+	{
+		send(0x24, 4000);
+		send(0x22, 1);
+		send(0x20, 0);
+		delay(HOST_EPD_REFRESH_MS);
+	}
+
+private:
+	void send(uint8_t command, size_t data_len)
+	{
+		SPI.beginTransaction(SPISettings(HOST_EPD_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+		SPI.transfer(command);
+		SPI.transfer(NULL, NULL, data_len);
+		SPI.endTransaction();
+	}
+};
+
+#endif // HOST_RAK14000_H
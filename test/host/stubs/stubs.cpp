@@ -0,0 +1,102 @@
+/**
+ * @file stubs.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Globals of the host stand-ins
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <WisBlock-API-V2.h>
+#include <nRF_SSD1306Wire.h>
+#include <rak14000.h>
+
+uint64_t host_time_us = 0;
+
+TwoWire Wire;
+SPIClass SPI;
+
+BLEUart g_ble_uart;
+bool g_ble_uart_is_connected = false;
+
+char host_log[HOST_LOG_SIZE];
+size_t host_log_len = 0;
+
+/**
+ * @brief Append to the collected log output, output beyond the buffer is dropped
+ *
+ * @param fmt format string
+ * @param ... arguments
+ */
+void host_log_printf(const char *fmt, ...)
+{
+	if (host_log_len >= HOST_LOG_SIZE - 1)
+	{
+		return;
+	}
+	va_list args;
+	va_start(args, fmt);
+	int len = vsnprintf(&host_log[host_log_len], HOST_LOG_SIZE - host_log_len, fmt, args);
+	va_end(args);
+	if (len > 0)
+	{
+		host_log_len = min(host_log_len + (size_t)len, (size_t)HOST_LOG_SIZE - 1);
+	}
+}
+
+/**
+ * @brief Drop the collected log output
+ *
+ */
+void host_log_clear(void)
+{
+	host_log_len = 0;
+	host_log[0] = 0;
+}
+
+/** Font selection only, the stand-in draws its own glyphs */
+const uint8_t ArialMT_Plain_10[] = {0};
+
+/** Printable ASCII, ' ' to '~' */
+#define HOST_FONT_CHARS 95
+
+static uint8_t font12_table[HOST_FONT_CHARS * 12 * 1];
+static uint8_t font20_table[HOST_FONT_CHARS * 20 * 2];
+
+sFONT Font12 = {font12_table, 7, 12};
+sFONT Font20 = {font20_table, 14, 20};
+
+/**
+ * @brief Fill a font table with a pattern per glyph, ' ' stays empty
+ *
+ * @param font font to fill
+ * @param table glyph data of the font
+ */
+static void host_font_fill(sFONT *font, uint8_t *table)
+{
+	uint8_t row_bytes = (font->Width + 7) / 8;
+	for (uint8_t glyph = 1; glyph < HOST_FONT_CHARS; glyph++)
+	{
+		for (uint8_t row = 0; row < font->Height; row++)
+		{
+			for (uint8_t col = 0; col < font->Width; col++)
+			{
+				if (((glyph * 31 + row * 7 + col * 13) ^ (glyph >> 1)) % 3 == 0)
+				{
+					table[(glyph * font->Height + row) * row_bytes + col / 8] |= 0x80 >> (col % 8);
+				}
+			}
+		}
+	}
+}
+
+/** Fills the font tables before main() */
+static struct host_font_init_s
+{
+	host_font_init_s()
+	{
+		host_font_fill(&Font12, font12_table);
+		host_font_fill(&Font20, font20_table);
+	}
+} host_font_init;
@@ -0,0 +1,134 @@
+/**
+ * @file test_ble_bench.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Host test of the BLE throughput frame protocol over the loopback link
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include "ble_bench.h"
+#include "ble_loopback.h"
+#include "host_test.h"
+
+int host_test_failures = 0;
+
+static ble_loopback_s link;
+static ble_bench_rx_s rx;
+
+/**
+ * @brief Send frames over the loopback and feed the receiver
+ *
+ * @param num_frames number of frames
+ * @param frame_size size of each frame
+ * @param first_seq sequence number of the first frame
+ * @param read_size size of the reads on the receiver side
+ */
+static void stream(uint32_t num_frames, uint16_t frame_size, uint16_t first_seq, uint16_t read_size)
+{
+	uint8_t frame[BLE_BENCH_MAX_FRAME];
+	uint8_t rx_buff[BLE_BENCH_MAX_FRAME];
+	uint16_t seq = first_seq;
+	for (uint32_t count = 0; count < num_frames; count++)
+	{
+		ble_bench_fill(frame, frame_size, seq++);
+		CHECK_EQ(ble_loopback_write(&link, frame, frame_size), frame_size);
+		uint16_t rx_len;
+		while ((rx_len = ble_loopback_read(&link, rx_buff, read_size)) != 0)
+		{
+			ble_bench_rx_feed(&rx, rx_buff, rx_len);
+		}
+	}
+}
+
+static void test_frame_layout(void)
+{
+	uint8_t frame[8];
+	ble_bench_fill(frame, sizeof(frame), 0x1234);
+	CHECK_EQ(frame[0], 0x34);
+	CHECK_EQ(frame[1], 0x12);
+	for (uint16_t idx = 2; idx < sizeof(frame); idx++)
+	{
+		CHECK_EQ(frame[idx], (uint8_t)(0x1234 + idx));
+	}
+}
+
+static void test_clean_stream(void)
+{
+	ble_loopback_init(&link, 247);
+	ble_bench_rx_init(&rx, 244);
+	stream(100, 244, 0, 100);
+	CHECK_EQ(rx.frames, 100);
+	CHECK_EQ(rx.bytes, 100 * 244);
+	CHECK_EQ(rx.next_seq, 100);
+	CHECK_EQ(rx.lost, 0);
+	CHECK_EQ(rx.corrupt, 0);
+	CHECK_EQ(rx.fill, 0);
+}
+
+static void test_split_frames(void)
+{
+	// Default MTU of 23, a frame needs 5 notifications, odd read size
+	ble_loopback_init(&link, 23);
+	ble_bench_rx_init(&rx, 100);
+	stream(50, 100, 0, 7);
+	CHECK_EQ(rx.frames, 50);
+	CHECK_EQ(rx.lost, 0);
+	CHECK_EQ(rx.corrupt, 0);
+}
+
+static void test_lost_frame(void)
+{
+	ble_loopback_init(&link, 53);
+	link.drop_idx = 10;
+	ble_bench_rx_init(&rx, 50);
+	stream(20, 50, 0, 64);
+	CHECK_EQ(rx.frames, 19);
+	CHECK_EQ(rx.lost, 1);
+	CHECK_EQ(rx.corrupt, 0);
+	CHECK_EQ(rx.next_seq, 20);
+}
+
+static void test_corrupt_frame(void)
+{
+	ble_loopback_init(&link, 53);
+	link.corrupt_idx = 5;
+	link.corrupt_offset = 10;
+	ble_bench_rx_init(&rx, 50);
+	stream(20, 50, 0, 64);
+	CHECK_EQ(rx.frames, 20);
+	CHECK_EQ(rx.lost, 0);
+	CHECK_EQ(rx.corrupt, 1);
+}
+
+static void test_seq_wrap(void)
+{
+	ble_loopback_init(&link, 247);
+	ble_bench_rx_init(&rx, 20);
+	rx.next_seq = 65530;
+	stream(12, 20, 65530, 20);
+	CHECK_EQ(rx.frames, 12);
+	CHECK_EQ(rx.lost, 0);
+	CHECK_EQ(rx.corrupt, 0);
+	CHECK_EQ(rx.next_seq, 6);
+}
+
+static void test_kbps(void)
+{
+	CHECK_EQ(ble_bench_kbps(1000, 8), 1000);
+	CHECK_EQ(ble_bench_kbps(1000, 0), 0);
+	CHECK_EQ(ble_bench_kbps(0xFFFFFFFF, 1000), 34359738);
+}
+
+int main(void)
+{
+	RUN_TEST(test_frame_layout);
+	RUN_TEST(test_clean_stream);
+	RUN_TEST(test_split_frames);
+	RUN_TEST(test_lost_frame);
+	RUN_TEST(test_corrupt_frame);
+	RUN_TEST(test_seq_wrap);
+	RUN_TEST(test_kbps);
+	return host_test_failures != 0;
+}
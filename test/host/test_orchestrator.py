@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+# Host test of tools/orchestrator.py against fake tester units on pseudo-terminals
+#
+#   python3 test/host/test_orchestrator.py     (also run by make -C test/host)
+#
+# tools/fake_tester.py runs as its own process with one pty per unit. The orchestrator
+# drives all units in parallel, the report must pass only the unit with all tests OK.
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+import unittest
+
+TOOLS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "tools")
+sys.path.insert(0, TOOLS)
+
+import orchestrator  # noqa: E402
+
+# Max time for all units, the timeout unit runs into it
+TIMEOUT = 3.0
+
+# Answer of a passing unit to AT+TEST=ALL
+ANSWER_PASS = ["+TEST:FLASH,OK,120", "+TEST:LORA,OK,45", "OK"]
+
+
+class OrchestratorTest(unittest.TestCase):
+
+    def setUp(self):
+        self.behaviours = ["pass", "fail", "timeout", "notests", "error", "pass"]
+        self.fake = subprocess.Popen([sys.executable, os.path.join(TOOLS, "fake_tester.py")] + self.behaviours,
+                                     stdin=subprocess.PIPE, stdout=subprocess.PIPE, universal_newlines=True)
+        self.ports = [self.fake.stdout.readline().strip() for _ in self.behaviours]
+        self.tmp = tempfile.TemporaryDirectory()
+
+    def tearDown(self):
+        self.fake.stdin.close()
+        self.fake.wait(5)
+        self.fake.stdout.close()
+        self.tmp.cleanup()
+
+    def run_units(self):
+        units = [orchestrator.Unit(port) for port in self.ports]
+        start = time.monotonic()
+        orchestrator.run(units, TIMEOUT)
+        elapsed = time.monotonic() - start
+        json_file = os.path.join(self.tmp.name, "report.json")
+        csv_file = os.path.join(self.tmp.name, "report.csv")
+        orchestrator.report(units, csv_file, json_file)
+        with open(json_file) as f:
+            rows = {behaviour + str(idx): row for idx, (behaviour, row) in enumerate(zip(self.behaviours, json.load(f)))}
+        return units, rows, elapsed, csv_file
+
+    def test_units(self):
+        units, rows, elapsed, csv_file = self.run_units()
+
+        # Units are served in parallel, the timeout unit only ends the run at the deadline
+        self.assertLess(elapsed, TIMEOUT + 1.5)
+
+        for key in ("pass0", "pass5"):
+            self.assertEqual(rows[key]["pass"], 1, rows[key])
+            self.assertEqual(rows[key]["error"], "")
+            self.assertEqual(rows[key]["LORA_test"], "OK")
+            self.assertEqual(rows[key]["LORA_ms"], 45)
+            self.assertEqual(rows[key]["SFLASH"], "3")
+
+        self.assertEqual(rows["fail1"]["pass"], 0)
+        self.assertEqual(rows["fail1"]["LORA_test"], "FAIL")
+        self.assertEqual(rows["fail1"]["LORA"], "0")
+        self.assertEqual(rows["fail1"]["error"], "")
+
+        self.assertEqual(rows["timeout2"]["pass"], 0)
+        self.assertIn("timeout", rows["timeout2"]["error"])
+        self.assertEqual(rows["timeout2"]["total_s"], "")
+
+        # OK to AT+TEST=ALL without a +TEST line must not pass
+        self.assertEqual(rows["notests3"]["pass"], 0)
+        self.assertEqual(rows["notests3"]["error"], "no +TEST lines")
+
+        self.assertEqual(rows["error4"]["pass"], 0)
+        self.assertIn("+CME ERROR", rows["error4"]["error"])
+
+        # Every unit has a line in the CSV
+        with open(csv_file) as f:
+            self.assertEqual(len(f.readlines()), len(self.behaviours) + 1)
+
+    def test_missing_result(self):
+        # A unit that never sends the result line does not pass even with all tests OK
+        unit = orchestrator.Unit("/dev/null")
+        unit.start = time.monotonic()
+        unit.state = "tests"
+        for line in ANSWER_PASS:
+            unit.feed((line + "\r\n").encode())
+        self.assertEqual(unit.state, "result")
+        json_file = os.path.join(self.tmp.name, "single.json")
+        orchestrator.report([unit], None, json_file)
+        with open(json_file) as f:
+            row = json.load(f)[0]
+        self.assertEqual(row["pass"], 0)
+        self.assertEqual(row["error"], "no AT+RESULT? line")
+
+
+if __name__ == "__main__":
+    unittest.main()
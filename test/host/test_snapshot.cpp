@@ -0,0 +1,637 @@
+/**
+ * @file test_snapshot.cpp
+ * @author Bernd Giesecke (bernd@giesecke.tk)
+ * @brief Host snapshot test of the display, report and GNSS paths against golden files
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Runs the AT+SNAP scenario and the GNSS poll on the firmware sources,
+ * built against the stand-ins in stubs/ (I2C and SPI bus with byte count
+ * and modeled bus time, SSD1306, RAK14000 Paint and panel, u-blox module).
+ * For each path the CRC-32 of the output, the I2C transactions and bytes,
+ * the SPI bytes, the simulated time (bus transfers and delays) and the CPU
+ * time are compared with golden/snapshots.txt. The CPU time is the median of
+ * SNAP_CPU_RUNS runs of the path, measured with CLOCK_PROCESS_CPUTIME_ID.
+ * The REFERENCE path is a fixed CRC-32 workload, its CPU time against the
+ * golden one scales the golden CPU times of the other paths to the speed of
+ * the PC in this run (clock, load).
+ * The test fails if an output changed, if a count or the simulated time grew
+ * more than SNAP_LIMIT_PCT percent, or if the scaled CPU time grew more than
+ * SNAP_CPU_LIMIT_PCT percent plus SNAP_CPU_SLACK_NS. SNAP_CPU=0 skips the
+ * CPU time check, e.g. on a PC very different from the recording one.
+ * The outputs are written to build/snap/ (text as .txt, framebuffers as
+ * plain PBM), the golden outputs are in golden/.
+ *
+ * After an intended change record new golden files and commit them:
+ *   make -C test/host snap-record
+ */
+#include "main.h"
+#include "snapshot_scenario.h"
+#include <nRF_SSD1306Wire.h>
+#include <sys/stat.h>
+#include "host_test.h"
+
+int host_test_failures = 0;
+
+/** Allowed growth of bytes and simulated time in percent */
+#ifndef SNAP_LIMIT_PCT
+#define SNAP_LIMIT_PCT 10
+#endif
+
+/** Runs of a path for the CPU time, the median is used */
+#ifndef SNAP_CPU_RUNS
+#define SNAP_CPU_RUNS 31
+#endif
+/** Allowed growth of the CPU time in percent, the CPU time is less stable than the counts */
+#ifndef SNAP_CPU_LIMIT_PCT
+#define SNAP_CPU_LIMIT_PCT 50
+#endif
+/** Allowed growth of the CPU time in ns on top, for the short paths */
+#ifndef SNAP_CPU_SLACK_NS
+#define SNAP_CPU_SLACK_NS 2000
+#endif
+
+#define SNAP_GOLDEN_DIR "golden"
+#define SNAP_OUT_DIR "build/snap"
+#define SNAP_GOLDEN_FILE SNAP_GOLDEN_DIR "/snapshots.txt"
+
+// Globals of main.cpp and boot_log.cpp used by the paths
+bool has_rak1921 = false;
+bool has_rak14000 = false;
+bool has_rak12500 = false;
+char disp_txt[DISP_TXT_SIZE];
+
+bool boot_log_active(void)
+{
+	return false;
+}
+
+void boot_log_printf(const char *tag, const char *fmt, ...)
+{
+	(void)tag;
+	(void)fmt;
+}
+
+extern SSD1306Wire oled_display;
+extern unsigned char *image;
+
+/** Navigation solutions until a fix, the fix is in the third solution */
+static const host_pvt_s gnss_fix[] = {
+	{0, 0, 0, 9999, 0, 0},
+	{-274780000, 1530400000, 52000, 450, 4, 2},
+	{-274789700, 1530410440, 35000, 120, 9, 3},
+};
+
+/** Navigation solutions that never get a fix */
+static const host_pvt_s gnss_no_fix[] = {
+	{0, 0, 0, 9999, 0, 0},
+	{0, 0, 0, 9999, 2, 0},
+};
+
+extern SFE_UBLOX_GNSS my_gnss;
+
+/** Size of the buffer of the REFERENCE path */
+#define SNAP_REF_SIZE 4096
+
+/** Measurement of a path */
+struct snap_s
+{
+	char path[24];
+	uint32_t crc;
+	uint32_t i2c_trans;
+	uint32_t i2c_bytes;
+	uint32_t spi_bytes;
+	uint32_t time_us;
+	uint32_t cpu_ns;
+};
+
+/** Golden measurements */
+#define SNAP_MAX_PATHS 16
+static snap_s golden[SNAP_MAX_PATHS];
+static uint8_t golden_num = 0;
+
+/** Measured paths, written as new golden file in record mode */
+static snap_s measured[SNAP_MAX_PATHS];
+static uint8_t measured_num = 0;
+
+static bool record = false;
+static bool check_cpu = true;
+
+/** Values at the start of a path */
+static host_bus_stat_s start_i2c;
+static uint32_t start_spi;
+static uint64_t start_us;
+
+/**
+ * @brief Directory for the outputs of this run
+ *
+ * @return const char* directory
+ */
+static const char *snap_dir(void)
+{
+	return record ? SNAP_GOLDEN_DIR : SNAP_OUT_DIR;
+}
+
+/**
+ * @brief Write a text output
+ *
+ * @param name file name without extension
+ * @param text text
+ * @param len length of the text
+ */
+static void snap_write_txt(const char *name, const char *text, size_t len)
+{
+	char file_name[64];
+	snprintf(file_name, sizeof(file_name), "%s/%s.txt", snap_dir(), name);
+	FILE *file = fopen(file_name, "w");
+	if (file == NULL)
+	{
+		printf("Cannot write %s\n", file_name);
+		host_test_failures++;
+		return;
+	}
+	fwrite(text, 1, len, file);
+	fclose(file);
+}
+
+/**
+ * @brief Write a 1 bit framebuffer as plain PBM, 1 = black
+ *
+ * @param name file name without extension
+ * @param width width in pixel
+ * @param height height in pixel
+ * @param pixel function that returns true for a black pixel
+ */
+static void snap_write_pbm(const char *name, int width, int height, bool (*pixel)(int x, int y))
+{
+	char file_name[64];
+	snprintf(file_name, sizeof(file_name), "%s/%s.pbm", snap_dir(), name);
+	FILE *file = fopen(file_name, "w");
+	if (file == NULL)
+	{
+		printf("Cannot write %s\n", file_name);
+		host_test_failures++;
+		return;
+	}
+	fprintf(file, "P1\n%d %d\n", width, height);
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			fputc(pixel(x, y) ? '1' : '0', file);
+		}
+		fputc('\n', file);
+	}
+	fclose(file);
+}
+
+/** OLED framebuffer, pages of 8 rows, LSB on top, lit pixel shown black */
+static bool oled_pixel(int x, int y)
+{
+	return (oled_display.buffer[x + (y / 8) * SSD1306Wire::width] & (1 << (y & 7))) != 0;
+}
+
+/** EPD display buffer, panel orientation, 128 x 250, MSB left, 0 = black */
+static bool epd_pixel(int x, int y)
+{
+	return (image[(x + y * 128) / 8] & (0x80 >> (x % 8))) == 0;
+}
+
+/**
+ * @brief Start the measurement of a path
+ *
+ */
+static void snap_begin(void)
+{
+	start_i2c = Wire.total();
+	start_spi = SPI.bytes;
+	start_us = host_time_us;
+}
+
+/**
+ * @brief End the measurement of a path
+ *
+ * @param path name of the path
+ * @param crc CRC-32 of the output
+ */
+static void snap_end(const char *path, uint32_t crc)
+{
+	host_bus_stat_s i2c = Wire.total();
+	snap_s *snap = &measured[measured_num++];
+	snprintf(snap->path, sizeof(snap->path), "%s", path);
+	snap->crc = crc;
+	snap->i2c_trans = i2c.transactions - start_i2c.transactions;
+	snap->i2c_bytes = i2c.bytes - start_i2c.bytes;
+	snap->spi_bytes = SPI.bytes - start_spi;
+	snap->time_us = (uint32_t)(host_time_us - start_us);
+}
+
+/**
+ * @brief Get the CPU time of the process
+ *
+ * @return uint64_t CPU time in ns
+ */
+static uint64_t snap_cpu_now(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+	return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static int snap_cmp_u32(const void *a, const void *b)
+{
+	uint32_t val_a = *(const uint32_t *)a;
+	uint32_t val_b = *(const uint32_t *)b;
+	return val_a < val_b ? -1 : (val_a > val_b ? 1 : 0);
+}
+
+/**
+ * @brief Measure the CPU time of the last ended path and print its measurement
+ *
+ * @param prepare brings the path to its start state, not measured, can be NULL
+ * @param run the path
+ */
+static void snap_cpu(void (*prepare)(void), void (*run)(void))
+{
+	uint32_t cpu_ns[SNAP_CPU_RUNS];
+	for (uint8_t idx = 0; idx < SNAP_CPU_RUNS; idx++)
+	{
+		if (prepare != NULL)
+		{
+			prepare();
+		}
+		uint64_t start = snap_cpu_now();
+		run();
+		cpu_ns[idx] = (uint32_t)(snap_cpu_now() - start);
+	}
+	qsort(cpu_ns, SNAP_CPU_RUNS, sizeof(cpu_ns[0]), snap_cmp_u32);
+
+	snap_s *snap = &measured[measured_num - 1];
+	snap->cpu_ns = cpu_ns[SNAP_CPU_RUNS / 2];
+	printf("  %-12s %08X i2c %u/%u spi %u time %u us cpu %u ns\n", snap->path, snap->crc, snap->i2c_trans,
+		   snap->i2c_bytes, snap->spi_bytes, snap->time_us, snap->cpu_ns);
+}
+
+/**
+ * @brief Read the golden measurements
+ *
+ * @return true if the file was read
+ */
+static bool golden_read(void)
+{
+	FILE *file = fopen(SNAP_GOLDEN_FILE, "r");
+	if (file == NULL)
+	{
+		return false;
+	}
+	char line[128];
+	while ((fgets(line, sizeof(line), file) != NULL) && (golden_num < SNAP_MAX_PATHS))
+	{
+		snap_s *snap = &golden[golden_num];
+		if ((line[0] == '#') ||
+			(sscanf(line, "%23s %x %u %u %u %u %u", snap->path, &snap->crc, &snap->i2c_trans, &snap->i2c_bytes,
+					&snap->spi_bytes, &snap->time_us, &snap->cpu_ns) != 7))
+		{
+			continue;
+		}
+		golden_num++;
+	}
+	fclose(file);
+	return true;
+}
+
+/**
+ * @brief Write the measurements as new golden file
+ *
+ */
+static void golden_write(void)
+{
+	FILE *file = fopen(SNAP_GOLDEN_FILE, "w");
+	if (file == NULL)
+	{
+		printf("Cannot write %s\n", SNAP_GOLDEN_FILE);
+		host_test_failures++;
+		return;
+	}
+	fprintf(file, "# path CRC-32 I2C-transactions I2C-bytes SPI-bytes simulated-time-us CPU-time-ns\n");
+	fprintf(file, "# written by make -C test/host snap-record\n");
+	for (uint8_t idx = 0; idx < measured_num; idx++)
+	{
+		snap_s *snap = &measured[idx];
+		fprintf(file, "%s %08X %u %u %u %u %u\n", snap->path, snap->crc, snap->i2c_trans, snap->i2c_bytes,
+				snap->spi_bytes, snap->time_us, snap->cpu_ns);
+	}
+	fclose(file);
+}
+
+/**
+ * @brief Check a count against the golden value and the limit
+ *
+ * @param path name of the path
+ * @param what name of the count
+ * @param value measured value
+ * @param limit golden value
+ */
+static void check_limit(const char *path, const char *what, uint32_t value, uint32_t limit)
+{
+	uint64_t max_value = (uint64_t)limit * (100 + SNAP_LIMIT_PCT) / 100;
+	if (value > max_value)
+	{
+		printf("%s: %s %u exceeds golden %u + %d%%\n", path, what, value, limit, SNAP_LIMIT_PCT);
+		host_test_failures++;
+	}
+}
+
+/**
+ * @brief Compare the measurements with the golden file
+ *
+ */
+static void golden_compare(void)
+{
+	// Speed of this run against the recording run, the REFERENCE path is the first one
+	uint32_t ref_now = measured[0].cpu_ns;
+	uint32_t ref_gold = ref_now;
+	for (uint8_t g_idx = 0; g_idx < golden_num; g_idx++)
+	{
+		if ((strcmp(golden[g_idx].path, "REFERENCE") == 0) && (golden[g_idx].cpu_ns != 0))
+		{
+			ref_gold = golden[g_idx].cpu_ns;
+		}
+	}
+	if (ref_now == 0)
+	{
+		ref_now = ref_gold = 1;
+	}
+	printf("CPU speed against the recording run: %u%%\n", (uint32_t)((uint64_t)ref_gold * 100 / ref_now));
+
+	for (uint8_t idx = 0; idx < measured_num; idx++)
+	{
+		snap_s *snap = &measured[idx];
+		snap_s *gold = NULL;
+		for (uint8_t g_idx = 0; g_idx < golden_num; g_idx++)
+		{
+			if (strcmp(golden[g_idx].path, snap->path) == 0)
+			{
+				gold = &golden[g_idx];
+			}
+		}
+		if (gold == NULL)
+		{
+			printf("%s: not in %s\n", snap->path, SNAP_GOLDEN_FILE);
+			host_test_failures++;
+			continue;
+		}
+		if (snap->crc != gold->crc)
+		{
+			printf("%s: output changed, CRC %08X != golden %08X, compare %s/%s.* with %s/%s.*\n", snap->path,
+				   snap->crc, gold->crc, SNAP_OUT_DIR, snap->path, SNAP_GOLDEN_DIR, snap->path);
+			host_test_failures++;
+		}
+		check_limit(snap->path, "I2C transactions", snap->i2c_trans, gold->i2c_trans);
+		check_limit(snap->path, "I2C bytes", snap->i2c_bytes, gold->i2c_bytes);
+		check_limit(snap->path, "SPI bytes", snap->spi_bytes, gold->spi_bytes);
+		check_limit(snap->path, "simulated time", snap->time_us, gold->time_us);
+		uint32_t gold_cpu_ns = (uint32_t)((uint64_t)gold->cpu_ns * ref_now / ref_gold);
+		uint64_t max_cpu_ns = (uint64_t)gold_cpu_ns * (100 + SNAP_CPU_LIMIT_PCT) / 100 + SNAP_CPU_SLACK_NS;
+		if (check_cpu && (snap->cpu_ns > max_cpu_ns))
+		{
+			printf("%s: CPU time %u ns exceeds scaled golden %u ns + %d%% + %d ns\n", snap->path, snap->cpu_ns,
+				   gold_cpu_ns, SNAP_CPU_LIMIT_PCT, SNAP_CPU_SLACK_NS);
+			host_test_failures++;
+		}
+	}
+	CHECK_EQ(measured_num, golden_num);
+}
+
+/**
+ * @brief Detect the modules, as the boot sequence does
+ *
+ */
+static void setup_modules(void)
+{
+	Wire.present[0x3c] = true;
+	Wire.present[0x42] = true;
+	i2c_bus_init();
+
+	CHECK(init_rak1921());
+	CHECK(has_rak1921);
+	has_rak14000 = init_rak14000();
+	CHECK(has_rak14000);
+	has_rak12500 = init_gnss();
+	CHECK(has_rak12500);
+
+	for (uint8_t field = 0; field < RESULT_NUM_FIELDS; field++)
+	{
+		result_set((result_field_e)field, snap_results[field]);
+	}
+}
+
+/** Input of the REFERENCE path */
+static uint8_t ref_buf[SNAP_REF_SIZE];
+static uint32_t ref_crc;
+
+static void run_reference(void)
+{
+	ref_crc = crc32_update(CRC32_INIT, ref_buf, sizeof(ref_buf));
+}
+
+/**
+ * @brief Fixed CPU workload, its CPU time scales the golden CPU times of the other paths
+ *
+ */
+static void test_reference(void)
+{
+	for (uint16_t idx = 0; idx < sizeof(ref_buf); idx++)
+	{
+		ref_buf[idx] = (uint8_t)(idx * 151 + (idx >> 8));
+	}
+	snap_begin();
+	run_reference();
+	snap_end("REFERENCE", ref_crc);
+	snap_cpu(NULL, run_reference);
+}
+
+/** Output of the RESULT path */
+static char result_line[96];
+
+static void run_result(void)
+{
+	result_serialize(result_line, sizeof(result_line));
+}
+
+/**
+ * @brief Result line, as sent by AT+RESULT?
+ *
+ */
+static void test_result(void)
+{
+	snap_begin();
+	run_result();
+	snap_end("RESULT", crc32_update(CRC32_INIT, (uint8_t *)result_line, strlen(result_line)));
+	snap_write_txt("RESULT", result_line, strlen(result_line));
+	snap_cpu(NULL, run_result);
+}
+
+static void run_oled_header(void)
+{
+	rak1921_result_view(RESULT_BIT(RESULT_NUM_FIELDS) - 1);
+}
+
+/**
+ * @brief OLED status bar
+ *
+ */
+static void test_oled_header(void)
+{
+	rak1921_header_invalidate();
+	snap_begin();
+	run_oled_header();
+	snap_end("OLED_HEADER", rak1921_crc());
+	snap_write_pbm("OLED_HEADER", SSD1306Wire::width, SSD1306Wire::height, oled_pixel);
+	snap_cpu(rak1921_header_invalidate, run_oled_header);
+}
+
+static void run_oled_lines(void)
+{
+	for (uint8_t idx = 0; idx < SNAP_NUM_LINES; idx++)
+	{
+		rak1921_add_line((char *)snap_lines[idx]);
+	}
+}
+
+/**
+ * @brief OLED log, each line updates the display
+ *
+ */
+static void test_oled_lines(void)
+{
+	rak1921_clear();
+	snap_begin();
+	run_oled_lines();
+	snap_end("OLED_LINES", rak1921_crc());
+	snap_write_pbm("OLED_LINES", SSD1306Wire::width, SSD1306Wire::height, oled_pixel);
+	snap_cpu(rak1921_clear, run_oled_lines);
+}
+
+/**
+ * @brief EPD result screen without the panel refresh, the blitter must match Paint::DrawStringAt()
+ *
+ */
+static void test_epd_compose(void)
+{
+	epd_use_blit = false;
+	compose_rak14000();
+	uint32_t paint_crc = rak14000_crc();
+	epd_use_blit = true;
+
+	snap_begin();
+	compose_rak14000();
+	snap_end("EPD_COMPOSE", rak14000_crc());
+	snap_write_pbm("EPD_COMPOSE", 128, 250, epd_pixel);
+	CHECK_EQ(rak14000_crc(), paint_crc);
+	snap_cpu(NULL, compose_rak14000);
+}
+
+/**
+ * @brief EPD result screen with the panel refresh
+ *
+ */
+static void test_epd_refresh(void)
+{
+	snap_begin();
+	refresh_rak14000();
+	snap_end("EPD_REFRESH", rak14000_crc());
+	snap_cpu(NULL, refresh_rak14000);
+}
+
+/** Script and result of the GNSS path */
+static const host_pvt_s *gnss_script;
+static uint8_t gnss_script_len;
+static bool gnss_result;
+
+static void prepare_gnss(void)
+{
+	rak1921_clear();
+	rak1921_show();
+	host_log_clear();
+	my_gnss.host_script(gnss_script, gnss_script_len);
+}
+
+static void run_gnss(void)
+{
+	gnss_result = poll_gnss();
+}
+
+/**
+ * @brief Poll the GNSS module with a list of solutions
+ *
+ * @param path name of the path
+ * @param script solutions
+ * @param num number of solutions
+ * @param expect_fix expected result of the poll
+ */
+static void gnss_path(const char *path, const host_pvt_s *script, uint8_t num, bool expect_fix)
+{
+	gnss_script = script;
+	gnss_script_len = num;
+	prepare_gnss();
+
+	snap_begin();
+	run_gnss();
+	uint32_t crc = crc32_update(CRC32_INIT, (uint8_t *)host_log, host_log_len);
+	crc = crc32_update(crc, oled_display.buffer, sizeof(oled_display.buffer));
+	snap_end(path, crc);
+
+	CHECK_EQ(gnss_result, expect_fix);
+	snap_write_txt(path, host_log, host_log_len);
+	snap_write_pbm(path, SSD1306Wire::width, SSD1306Wire::height, oled_pixel);
+	snap_cpu(prepare_gnss, run_gnss);
+}
+
+static void test_gnss_fix(void)
+{
+	gnss_path("GNSS_FIX", gnss_fix, sizeof(gnss_fix) / sizeof(gnss_fix[0]), true);
+}
+
+static void test_gnss_no_fix(void)
+{
+	gnss_path("GNSS_NOFIX", gnss_no_fix, sizeof(gnss_no_fix) / sizeof(gnss_no_fix[0]), false);
+}
+
+int main(void)
+{
+	const char *record_env = getenv("SNAP_RECORD");
+	record = (record_env != NULL) && (record_env[0] != 0) && (record_env[0] != '0');
+	const char *cpu_env = getenv("SNAP_CPU");
+	check_cpu = (cpu_env == NULL) || (cpu_env[0] != '0');
+	mkdir("build", 0755);
+	mkdir(snap_dir(), 0755);
+
+	setup_modules();
+	RUN_TEST(test_reference);
+	RUN_TEST(test_result);
+	RUN_TEST(test_oled_header);
+	RUN_TEST(test_oled_lines);
+	RUN_TEST(test_epd_compose);
+	RUN_TEST(test_epd_refresh);
+	RUN_TEST(test_gnss_fix);
+	RUN_TEST(test_gnss_no_fix);
+
+	if (record)
+	{
+		golden_write();
+		printf("Recorded %s\n", SNAP_GOLDEN_FILE);
+	}
+	else if (!golden_read())
+	{
+		printf("No %s, run make -C test/host snap-record\n", SNAP_GOLDEN_FILE);
+		host_test_failures++;
+	}
+	else
+	{
+		golden_compare();
+	}
+	return host_test_failures != 0;
+}
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+# BLE UART throughput test against the WisBlock HW tester
+#
+# Requires bleak (pip install bleak)
+#   python3 tools/ble_bench.py --name RAK-TEST --seconds 10 --frames 500
+#
+# The tester negotiates MTU, data length and connection interval, then
+#   BENCH=TX  streams frames to this host for <seconds>
+#   BENCH=RX  receives <frames> frames from this host
+# Both directions check the sequence number and the test pattern (see src/ble_bench.h).
+
+import argparse
+import asyncio
+import time
+
+from bleak import BleakClient, BleakScanner
+
+NUS_RX = "6e400002-b5a3-f393-e0a9-e50e24dcca9e"  # host -> device
+NUS_TX = "6e400003-b5a3-f393-e0a9-e50e24dcca9e"  # device -> host
+
+
+def fill(seq, frame_size):
+    return bytes([seq & 0xFF, (seq >> 8) & 0xFF] + [(seq + idx) & 0xFF for idx in range(2, frame_size)])
+
+
+class Receiver:
+    """Same frame check as ble_bench_rx_feed() in the firmware"""
+
+    def __init__(self, frame_size):
+        self.frame_size = frame_size
+        self.buf = bytearray()
+        self.next_seq = 0
+        self.frames = 0
+        self.lost = 0
+        self.corrupt = 0
+        self.start = None
+        self.last = None
+
+    def feed(self, data):
+        now = time.monotonic()
+        if self.start is None:
+            self.start = now
+        self.last = now
+        self.buf += data
+        while len(self.buf) >= self.frame_size:
+            frame = bytes(self.buf[:self.frame_size])
+            del self.buf[:self.frame_size]
+            seq = frame[0] | (frame[1] << 8)
+            if seq != self.next_seq:
+                self.lost += (seq - self.next_seq) & 0xFFFF
+            if frame != fill(seq, self.frame_size):
+                self.corrupt += 1
+            self.next_seq = (seq + 1) & 0xFFFF
+            self.frames += 1
+
+
+async def run(args):
+    device = await BleakScanner.find_device_by_filter(
+        lambda dev, _: dev.name is not None and dev.name.startswith(args.name), timeout=10)
+    if device is None:
+        raise SystemExit("Device %s not found" % args.name)
+
+    async with BleakClient(device) as client:
+        lines = asyncio.Queue()
+        text = bytearray()
+        receiver = None
+        receiving = False
+
+        def on_notify(_, data):
+            nonlocal text, receiver
+            if receiver is not None and not data.startswith(b"BENCH,"):
+                receiver.feed(data)
+                return
+            text += data
+            while b"\n" in text:
+                line, _, text = text.partition(b"\n")
+                line = line.decode(errors="replace").strip()
+                if line.startswith("BENCH,START") and receiving:
+                    # Everything after this line is pattern data
+                    receiver = Receiver(int(line.split(",")[2]))
+                    text = bytearray()
+                    return
+                lines.put_nowait(line)
+
+        await client.start_notify(NUS_TX, on_notify)
+        max_write = client.mtu_size - 3
+
+        async def wait_for(prefix, timeout):
+            while True:
+                line = await asyncio.wait_for(lines.get(), timeout)
+                if line.startswith(prefix):
+                    return line
+
+        # Device to host
+        receiving = True
+        await client.write_gatt_char(NUS_RX, ("BENCH=TX,%d,%d\n" % (args.seconds, args.frame_size or max_write)).encode())
+        result = await wait_for("BENCH,TX", args.seconds + 10)
+        receiving = False
+        print("Device: " + result)
+        if receiver is not None and receiver.start is not None:
+            duration = max(receiver.last - receiver.start, 1e-3)
+            print("Host RX: %d frames, %.1f kbit/s, lost %d, corrupt %d" % (
+                receiver.frames, receiver.frames * receiver.frame_size * 8 / duration / 1000,
+                receiver.lost, receiver.corrupt))
+        receiver = None
+
+        # Host to device
+        await client.write_gatt_char(NUS_RX, ("BENCH=RX,%d,%d\n" % (args.frames, args.frame_size or max_write)).encode())
+        ready = await wait_for("BENCH,READY", 10)
+        frame_size = int(ready.split(",")[2])
+        start = time.monotonic()
+        for seq in range(args.frames):
+            await client.write_gatt_char(NUS_RX, fill(seq & 0xFFFF, frame_size), response=False)
+        result = await wait_for("BENCH,RX", 30)
+        print("Host TX: %d frames in %.2f s" % (args.frames, time.monotonic() - start))
+        print("Device: " + result)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="BLE UART throughput test for the WisBlock HW tester")
+    parser.add_argument("--name", default="RAK-TEST", help="BLE name (prefix) of the tester")
+    parser.add_argument("--seconds", type=int, default=10, help="duration of the device to host test")
+    parser.add_argument("--frames", type=int, default=500, help="number of frames for the host to device test")
+    parser.add_argument("--frame-size", type=int, default=0, help="frame size, default MTU - 3")
+    asyncio.run(run(parser.parse_args()))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+# Fake WisBlock HW tester units on pseudo-terminals, for testing tools/orchestrator.py without hardware
+#
+#   python3 tools/fake_tester.py pass fail timeout notests error
+#
+# One pty per argument. The slave paths are printed one per line on stdout, in the
+# order of the arguments, then the units are served until stdin is closed.
+# Behaviour of a unit on AT+TEST=ALL:
+#   pass     all +TEST lines OK, then OK
+#   fail     one +TEST line FAIL, then OK
+#   timeout  no answer at all
+#   notests  OK without any +TEST line
+#   error    +CME ERROR:5
+# AT+RESULT? is answered with a result line and OK by all units that answer.
+
+import os
+import selectors
+import sys
+import tty
+
+TESTS_OK = ["+TEST:FLASH,OK,120", "+TEST:SFLASH_ID,OK,3", "+TEST:LORA,OK,45", "+TEST:I2C,OK,210"]
+TESTS_FAIL = ["+TEST:FLASH,OK,118", "+TEST:SFLASH_ID,OK,3", "+TEST:LORA,FAIL,1002", "+TEST:I2C,OK,205"]
+RESULT_LINE = "OLED=1,EPD=0,I2C=3,FLASH=1,LORA=%d,TX=2,GNSS=0,BATT=4012,SFLASH=3"
+
+BEHAVIOURS = ("pass", "fail", "timeout", "notests", "error")
+
+
+def answer(behaviour, cmd):
+    """Return the lines a unit sends for a command"""
+    if behaviour == "timeout":
+        return []
+    if cmd == "AT+TEST=ALL":
+        if behaviour == "pass":
+            return TESTS_OK + ["OK"]
+        if behaviour == "fail":
+            return TESTS_FAIL + ["OK"]
+        if behaviour == "notests":
+            return ["OK"]
+        return ["+CME ERROR:5"]
+    if cmd == "AT+RESULT?":
+        return [RESULT_LINE % (0 if behaviour == "fail" else 1), "OK"]
+    return ["AT_ERROR"]
+
+
+def main():
+    behaviours = sys.argv[1:]
+    for behaviour in behaviours:
+        if behaviour not in BEHAVIOURS:
+            sys.exit("Unknown behaviour %s, use %s" % (behaviour, "|".join(BEHAVIOURS)))
+
+    sel = selectors.DefaultSelector()
+    slaves = []
+    for behaviour in behaviours:
+        master, slave = os.openpty()
+        # No echo and no line ending translation until the orchestrator opens the port
+        tty.setraw(slave)
+        slaves.append(slave)
+        sel.register(master, selectors.EVENT_READ, [behaviour, bytearray()])
+        print(os.ttyname(slave))
+    sys.stdout.flush()
+    sel.register(sys.stdin, selectors.EVENT_READ, None)
+
+    while True:
+        for key, _ in sel.select():
+            if key.data is None:
+                if not sys.stdin.readline():
+                    return
+                continue
+            behaviour, rx = key.data
+            try:
+                rx += os.read(key.fd, 1024)
+            except OSError:
+                # The orchestrator closed the port
+                continue
+            while b"\n" in rx:
+                pos = rx.find(b"\n")
+                cmd = rx[:pos].decode("utf-8", "replace").strip()
+                del rx[:pos + 1]
+                lines = answer(behaviour, cmd)
+                if lines:
+                    os.write(key.fd, ("\r\n".join(lines) + "\r\n").encode())
+
+
+if __name__ == "__main__":
+    main()
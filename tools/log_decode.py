@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+# Decoder for the deferred binary log (LOG_DEFERRED=1)
+#
+# The firmware sends only the address of the format string, the address of the tag
+# and the raw arguments. The strings are looked up in the ELF file of the same build.
+#
+# Usage:
+#   python3 tools/log_decode.py Generated/WB_HW_Test_V1.1.6.elf capture.bin
+#   python3 tools/log_decode.py Generated/WB_HW_Test_V1.1.6.elf --port /dev/ttyACM0
+#
+# Bytes that are not part of a valid frame (e.g. text output of the WisBlock API) are
+# passed through unchanged.
+
+import argparse
+import re
+import struct
+import sys
+
+LOG_SYNC = 0xA5
+LOG_HEADER_SIZE = 14
+LOG_TRUNCATED = 0x80
+
+# printf conversion specification
+SPEC_RE = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+))?(hh|h|ll|l|z|j|t|L)?([diouxXcsfFeEgGp%])")
+
+
+class ElfImage:
+    """Minimal ELF32 little endian reader, resolves addresses of loadable segments"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[0:4] != b"\x7fELF" or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError("Not a 32 bit little endian ELF file: " + path)
+        (e_phoff,) = struct.unpack_from("<I", self.data, 0x1C)
+        e_phentsize, e_phnum = struct.unpack_from("<HH", self.data, 0x2A)
+        self.segments = []
+        for idx in range(e_phnum):
+            p_type, p_offset, p_vaddr, p_paddr, p_filesz = struct.unpack_from(
+                "<IIIII", self.data, e_phoff + idx * e_phentsize)
+            if p_type == 1 and p_filesz > 0:
+                self.segments.append((p_vaddr, p_offset, p_filesz))
+        self.cache = {}
+
+    def string_at(self, addr):
+        if addr == 0:
+            return None
+        if addr in self.cache:
+            return self.cache[addr]
+        result = "<0x%08X>" % addr
+        for vaddr, offset, size in self.segments:
+            if vaddr <= addr < vaddr + size:
+                start = offset + addr - vaddr
+                end = self.data.find(b"\x00", start, offset + size)
+                if end >= 0:
+                    result = self.data[start:end].decode("utf-8", "replace")
+                break
+        self.cache[addr] = result
+        return result
+
+
+def format_entry(fmt, args):
+    """Rebuild the text from the format string and the raw argument bytes"""
+    pos = 0
+    out = []
+    last = 0
+    for match in SPEC_RE.finditer(fmt):
+        out.append(fmt[last:match.start()])
+        last = match.end()
+        flags, width, prec, length, conv = match.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if width == "*":
+            (width,) = struct.unpack_from("<i", args, pos)
+            width = str(width)
+            pos += 4
+        spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+        try:
+            if conv == "s":
+                str_len = args[pos]
+                value = args[pos + 1:pos + 1 + str_len].decode("utf-8", "replace")
+                pos += 1 + str_len
+                out.append((spec + "s") % value)
+            elif conv in "fFeEgG":
+                (value,) = struct.unpack_from("<f", args, pos)
+                pos += 4
+                out.append((spec + conv) % value)
+            elif length == "ll":
+                signed = conv in "di"
+                (value,) = struct.unpack_from("<q" if signed else "<Q", args, pos)
+                pos += 8
+                out.append((spec + conv.replace("u", "d")) % value)
+            elif conv == "p":
+                (value,) = struct.unpack_from("<I", args, pos)
+                pos += 4
+                out.append("0x%08x" % value)
+            elif conv == "c":
+                (value,) = struct.unpack_from("<I", args, pos)
+                pos += 4
+                out.append((spec + "c") % (value & 0xFF))
+            else:
+                signed = conv in "di"
+                (value,) = struct.unpack_from("<i" if signed else "<I", args, pos)
+                pos += 4
+                if length == "hh":
+                    value &= 0xFF
+                elif length == "h":
+                    value &= 0xFFFF
+                out.append((spec + conv.replace("u", "d")) % value)
+        except (struct.error, IndexError):
+            out.append("<missing>")
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+def decode_stream(elf, read_chunk, write):
+    """Split the byte stream into frames and plain text"""
+    buf = bytearray()
+    while True:
+        chunk = read_chunk()
+        if chunk is None:
+            break
+        buf += chunk
+        while buf:
+            if buf[0] != LOG_SYNC:
+                end = buf.find(bytes([LOG_SYNC]))
+                if end < 0:
+                    end = len(buf)
+                write(buf[:end].decode("utf-8", "replace"))
+                del buf[:end]
+                continue
+            if len(buf) < 2:
+                break
+            truncated = (buf[1] & LOG_TRUNCATED) != 0
+            frame_len = LOG_HEADER_SIZE + (buf[1] & ~LOG_TRUNCATED) + 1
+            if len(buf) < frame_len:
+                break
+            checksum = 0
+            for byte in buf[1:frame_len - 1]:
+                checksum ^= byte
+            if checksum != buf[frame_len - 1]:
+                # Not a frame, pass the sync byte through as text
+                write(chr(buf[0]))
+                del buf[:1]
+                continue
+            timestamp, fmt_addr, tag_addr = struct.unpack_from("<III", buf, 2)
+            args = bytes(buf[LOG_HEADER_SIZE:frame_len - 1])
+            del buf[:frame_len]
+            tag = elf.string_at(tag_addr)
+            text = format_entry(elf.string_at(fmt_addr), args)
+            if truncated:
+                text += " <truncated>"
+            if tag:
+                write("%10d [%s] %s\n" % (timestamp, tag, text))
+            else:
+                write("%10d %s\n" % (timestamp, text))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode deferred binary log of the WisBlock HW tester")
+    parser.add_argument("elf", help="ELF file of the firmware that produced the log")
+    parser.add_argument("input", nargs="?", help="captured log file, stdin if omitted")
+    parser.add_argument("--port", help="read directly from a serial port (requires pyserial)")
+    args = parser.parse_args()
+
+    elf = ElfImage(args.elf)
+
+    def write(text):
+        sys.stdout.write(text)
+        sys.stdout.flush()
+
+    if args.port:
+        import serial
+        port = serial.Serial(args.port, 115200, timeout=0.1)
+        decode_stream(elf, lambda: port.read(4096), write)
+    elif args.input:
+        with open(args.input, "rb") as f:
+            decode_stream(elf, lambda: f.read(4096) or None, write)
+    else:
+        decode_stream(elf, lambda: sys.stdin.buffer.read1(4096) or None, write)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+# Run the WisBlock HW tester on many units in parallel over USB
+#
+# All ports are handled in one epoll loop (selectors module), no thread per port,
+# so 50+ units on one PC are no problem. No extra Python packages are required.
+#
+#   python3 tools/orchestrator.py                        # all /dev/ttyACM* ports
+#   python3 tools/orchestrator.py /dev/ttyACM0 /dev/pts/5 --csv report.csv --json report.json
+#
+# For each unit the script sends AT+TEST=ALL, collects the +TEST:<name>,<OK|FAIL>,<ms>
+# lines, then reads the summary with AT+RESULT? and writes an aggregated report.
+# A unit passes only with at least one +TEST line, all of them OK, and a result line.
+# Any path to a character device works, e.g. pseudo-terminals of tools/fake_tester.py
+# (see test/host/test_orchestrator.py).
+
+import argparse
+import csv
+import glob
+import json
+import os
+import re
+import selectors
+import sys
+import termios
+import time
+
+TEST_RE = re.compile(r"\+TEST:(\w+),(OK|FAIL),(\d+)")
+RESULT_RE = re.compile(r"(OLED=\d+(?:,\w+=\d+)+)")
+
+
+class Unit:
+    """State of one tester on one serial port"""
+
+    def __init__(self, port):
+        self.port = port
+        self.fd = None
+        self.rx = bytearray()
+        self.tx = bytearray()
+        self.state = "open"
+        self.start = None
+        self.done_time = None
+        self.tests = {}
+        self.result = {}
+        self.error = ""
+        self.log = []
+
+    def open(self):
+        self.fd = os.open(self.port, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+        if os.isatty(self.fd):
+            attrs = termios.tcgetattr(self.fd)
+            # Raw mode, 115200 8N1 (baudrate is ignored by USB CDC)
+            attrs[0] = 0
+            attrs[1] = 0
+            attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+            attrs[3] = 0
+            attrs[4] = attrs[5] = termios.B115200
+            attrs[6][termios.VMIN] = 0
+            attrs[6][termios.VTIME] = 0
+            termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+        self.start = time.monotonic()
+
+    def send(self, cmd):
+        self.tx += (cmd + "\r\n").encode()
+
+    def handle_line(self, line):
+        self.log.append(line)
+        match = TEST_RE.search(line)
+        if match:
+            name, status, duration = match.groups()
+            self.tests[name] = (status, int(duration), time.monotonic() - self.start)
+            return
+        match = RESULT_RE.search(line)
+        if match and self.state == "result":
+            self.result = dict(item.split("=") for item in match.group(1).split(","))
+            self.state = "done"
+            self.done_time = time.monotonic() - self.start
+            return
+        if self.state == "tests" and line.strip() == "OK":
+            # AT+TEST=ALL finished
+            self.state = "result"
+            self.send("AT+RESULT?")
+        elif line.startswith("+CME ERROR") or line.startswith("AT_ERROR"):
+            self.error = line.strip()
+            self.state = "done"
+            self.done_time = time.monotonic() - self.start
+
+    def feed(self, data):
+        self.rx += data
+        while True:
+            pos = self.rx.find(b"\n")
+            if pos < 0:
+                break
+            line = self.rx[:pos].decode("utf-8", "replace").rstrip("\r")
+            del self.rx[:pos + 1]
+            self.handle_line(line)
+
+
+def run(units, timeout):
+    sel = selectors.DefaultSelector()
+    for unit in units:
+        try:
+            unit.open()
+        except OSError as err:
+            unit.error = str(err)
+            unit.state = "done"
+            continue
+        unit.state = "tests"
+        unit.send("AT+TEST=ALL")
+        sel.register(unit.fd, selectors.EVENT_READ | selectors.EVENT_WRITE, unit)
+
+    deadline = time.monotonic() + timeout
+    while any(unit.state != "done" for unit in units):
+        remaining = deadline - time.monotonic()
+        if remaining <= 0:
+            break
+        for key, events in sel.select(min(remaining, 1.0)):
+            unit = key.data
+            if events & selectors.EVENT_READ:
+                try:
+                    data = os.read(unit.fd, 4096)
+                except BlockingIOError:
+                    data = None
+                except OSError as err:
+                    # Unit disconnected
+                    unit.error = str(err)
+                    unit.state = "done"
+                    sel.unregister(unit.fd)
+                    continue
+                if data:
+                    unit.feed(data)
+            if events & selectors.EVENT_WRITE and unit.tx:
+                try:
+                    sent = os.write(unit.fd, unit.tx)
+                    del unit.tx[:sent]
+                except BlockingIOError:
+                    pass
+            # Only wait for write readiness while there is something to send
+            wanted = selectors.EVENT_READ | (selectors.EVENT_WRITE if unit.tx else 0)
+            if unit.state != "done" and key.events != wanted:
+                sel.modify(unit.fd, wanted, unit)
+            elif unit.state == "done":
+                sel.unregister(unit.fd)
+
+    for unit in units:
+        if unit.state != "done":
+            unit.error = unit.error or "timeout in state " + unit.state
+        if unit.fd is not None:
+            os.close(unit.fd)
+    sel.close()
+
+
+def report(units, csv_file, json_file):
+    test_names = sorted({name for unit in units for name in unit.tests})
+    result_keys = sorted({key for unit in units for key in unit.result})
+    rows = []
+    for unit in units:
+        error = unit.error
+        if not error and not unit.tests:
+            # OK to AT+TEST=ALL without a single test is not a pass
+            error = "no +TEST lines"
+        elif not error and not unit.result:
+            error = "no AT+RESULT? line"
+        row = {"port": unit.port,
+               "pass": int(not error and all(t[0] == "OK" for t in unit.tests.values())),
+               "total_s": round(unit.done_time, 3) if unit.done_time is not None else "",
+               "error": error}
+        for name in test_names:
+            status, duration, _ = unit.tests.get(name, ("", "", ""))
+            row[name + "_test"] = status
+            row[name + "_ms"] = duration
+        for key in result_keys:
+            row[key] = unit.result.get(key, "")
+        rows.append(row)
+
+    if csv_file:
+        with open(csv_file, "w", newline="") as f:
+            writer = csv.DictWriter(f, fieldnames=list(rows[0].keys()) if rows else ["port"])
+            writer.writeheader()
+            writer.writerows(rows)
+    if json_file:
+        with open(json_file, "w") as f:
+            json.dump(rows, f, indent=1)
+
+    for row in rows:
+        print("%-24s %s %8s %s" % (row["port"], "PASS" if row["pass"] else "FAIL", row["total_s"], row["error"]))
+    print("%d of %d units passed" % (sum(row["pass"] for row in rows), len(rows)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Run the WisBlock HW tester on many units in parallel")
+    parser.add_argument("ports", nargs="*", help="serial ports, default all /dev/ttyACM*")
+    parser.add_argument("--timeout", type=float, default=120, help="max time in seconds for all units")
+    parser.add_argument("--csv", help="write CSV report")
+    parser.add_argument("--json", help="write JSON report")
+    args = parser.parse_args()
+
+    ports = args.ports or sorted(glob.glob("/dev/ttyACM*"))
+    if not ports:
+        sys.exit("No serial ports found")
+
+    units = [Unit(port) for port in ports]
+    run(units, args.timeout)
+    report(units, args.csv, args.json)
+
+
+if __name__ == "__main__":
+    main()
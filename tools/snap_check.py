@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+# Regression check of the display and report paths against a golden file
+#
+# AT+SNAP renders fixed results and log lines and answers per path with
+# +SNAP:<path>,<CRC-32>,<cycles>,<I2C transactions>,<I2C bus us> (or +SNAP:<path>,NA).
+# The CRC covers the produced text or framebuffer.
+#
+#   python3 tools/snap_check.py golden.json --port /dev/ttyACM0 --record   # store a golden file
+#   python3 tools/snap_check.py golden.json --port /dev/ttyACM0            # compare
+#   python3 tools/snap_check.py golden.json capture.txt                    # compare a captured answer
+#
+# The exit code is 1 if an output changed, a path is missing, the I2C transactions grew,
+# or cycles or I2C bus time grew more than the threshold.
+
+import argparse
+import json
+import re
+import sys
+import time
+
+SNAP_RE = re.compile(r"\+SNAP:(\w+),(?:NA|([0-9A-F]{8}),(\d+),(\d+),(\d+))")
+
+
+def parse(lines):
+    """Return a dict path -> dict with crc, cycles, i2c_trans, i2c_us, or None if not available"""
+    paths = {}
+    for line in lines:
+        match = SNAP_RE.search(line)
+        if not match:
+            continue
+        path, crc, cycles, trans, busy_us = match.groups()
+        if crc is None:
+            paths[path] = None
+        else:
+            paths[path] = {"crc": crc, "cycles": int(cycles), "i2c_trans": int(trans), "i2c_us": int(busy_us)}
+    return paths
+
+
+def read_port(port_name):
+    import serial
+    with serial.Serial(port_name, 115200, timeout=2) as port:
+        port.reset_input_buffer()
+        port.write(b"AT+SNAP\r\n")
+        lines = []
+        end = time.monotonic() + 30
+        while time.monotonic() < end:
+            line = port.readline().decode("ascii", "replace")
+            if not line:
+                continue
+            lines.append(line)
+            if line.strip() in ("OK", "ERROR") or line.startswith("+CME ERROR"):
+                break
+        return lines
+
+
+def grew(new, old, threshold):
+    return new > old * (1 + threshold / 100.0)
+
+
+def compare(golden, current, cycles_threshold, bus_threshold):
+    """Print a table and return the number of failures"""
+    failures = 0
+    print("%-12s %-8s %10s %10s %7s %9s  %s" % ("path", "crc", "cycles", "golden", "i2c_tr", "i2c_us", "result"))
+    for path in sorted(set(golden) | set(current)):
+        old = golden.get(path, "missing")
+        new = current.get(path, "missing")
+        errors = []
+        if old == "missing" or new == "missing":
+            errors.append("missing in " + ("golden" if old == "missing" else "answer"))
+        elif old is None or new is None:
+            if old is not new:
+                errors.append("module not available" if new is None else "module available now")
+        else:
+            if new["crc"] != old["crc"]:
+                errors.append("output changed")
+            if grew(new["cycles"], old["cycles"], cycles_threshold):
+                errors.append("cycles +%d%%" % (100 * (new["cycles"] - old["cycles"]) // max(old["cycles"], 1)))
+            if new["i2c_trans"] > old["i2c_trans"]:
+                errors.append("I2C transactions %d > %d" % (new["i2c_trans"], old["i2c_trans"]))
+            if grew(new["i2c_us"], old["i2c_us"], bus_threshold):
+                errors.append("I2C time +%d%%" % (100 * (new["i2c_us"] - old["i2c_us"]) // max(old["i2c_us"], 1)))
+        if isinstance(new, dict):
+            print("%-12s %-8s %10d %10s %7d %9d  %s" % (
+                path, new["crc"], new["cycles"], old["cycles"] if isinstance(old, dict) else "-",
+                new["i2c_trans"], new["i2c_us"], ", ".join(errors) or "ok"))
+        else:
+            print("%-12s %-8s %10s %10s %7s %9s  %s" % (path, new or "NA", "-", "-", "-", "-", ", ".join(errors) or "ok"))
+        failures += len(errors) != 0
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare AT+SNAP of the WisBlock HW tester with a golden file")
+    parser.add_argument("golden", help="golden JSON file")
+    parser.add_argument("input", nargs="?", help="captured AT+SNAP answer, stdin if omitted")
+    parser.add_argument("--port", help="send AT+SNAP to a serial port (requires pyserial)")
+    parser.add_argument("--record", action="store_true", help="write the answer as new golden file")
+    parser.add_argument("--cycles-threshold", type=float, default=10, help="allowed CPU cycle growth in %% (10)")
+    parser.add_argument("--bus-threshold", type=float, default=10, help="allowed I2C bus time growth in %% (10)")
+    args = parser.parse_args()
+
+    if args.port:
+        lines = read_port(args.port)
+    elif args.input:
+        with open(args.input) as f:
+            lines = f.readlines()
+    else:
+        lines = sys.stdin.readlines()
+
+    current = parse(lines)
+    if not current:
+        sys.exit("No +SNAP lines in the answer")
+
+    if args.record:
+        with open(args.golden, "w") as f:
+            json.dump(current, f, indent=2, sort_keys=True)
+        print("Recorded %d paths to %s" % (len(current), args.golden))
+        return
+
+    with open(args.golden) as f:
+        golden = json.load(f)
+    failures = compare(golden, current, args.cycles_threshold, args.bus_threshold)
+    if failures:
+        print("%d path(s) regressed" % failures)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+# Decoder for the soak test log (SOAK_TEST=1)
+#
+# The firmware exports the log with AT+SOAKDUMP as lines "+SOAKDUMP:<hex>" and a last
+# line "+SOAKDUMP:END,<bytes>,<CRC-32>". Each sample holds uptime, battery, RSSI and
+# GNSS quality as zig-zag varint differences to the sample before.
+#
+# Usage:
+#   python3 tools/soak_decode.py capture.txt > soak.csv
+#   python3 tools/soak_decode.py --port /dev/ttyACM0 --plot
+#
+# Each boot and each new log file starts a new segment, the segment number is the first CSV column.
+
+import argparse
+import sys
+import zlib
+
+SOAK_TAG_SEGMENT = 0x53
+SOAK_TAG_SAMPLE = 0x01
+FIELDS = ("time_s", "batt_mv", "rssi", "sats", "hdop", "fix")
+
+
+def read_dump(lines):
+    """Collect the hex lines, check length and CRC"""
+    data = bytearray()
+    for line in lines:
+        line = line.strip()
+        if not line.startswith("+SOAKDUMP:"):
+            continue
+        payload = line[len("+SOAKDUMP:"):]
+        if payload.startswith("END,"):
+            _, size, crc = payload.split(",")
+            if int(size) != len(data):
+                raise ValueError("got %d bytes, expected %s" % (len(data), size))
+            if int(crc, 16) != zlib.crc32(bytes(data)):
+                raise ValueError("CRC mismatch")
+            return bytes(data)
+        data += bytes.fromhex(payload)
+    raise ValueError("no +SOAKDUMP:END line, dump incomplete")
+
+
+def varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, pos
+
+
+def decode(data):
+    """Return a list of (segment, sample dict)"""
+    samples = []
+    segment = -1
+    last = None
+    pos = 0
+    while pos < len(data):
+        tag = data[pos]
+        pos += 1
+        if tag == SOAK_TAG_SEGMENT:
+            version, pos = varint(data, pos)
+            if version != 1:
+                raise ValueError("unknown segment version %d at byte %d" % (version, pos))
+            segment += 1
+            last = [0] * len(FIELDS)
+        elif tag == SOAK_TAG_SAMPLE and last is not None:
+            for idx in range(len(FIELDS)):
+                zigzag, pos = varint(data, pos)
+                last[idx] += (zigzag >> 1) ^ -(zigzag & 1)
+            samples.append((segment, dict(zip(FIELDS, last))))
+        else:
+            raise ValueError("bad record tag 0x%02X at byte %d" % (tag, pos - 1))
+    return samples
+
+
+def read_port(port_name):
+    import serial
+    with serial.Serial(port_name, 115200, timeout=5) as port:
+        port.reset_input_buffer()
+        port.write(b"AT+SOAKDUMP\r\n")
+        lines = []
+        while True:
+            line = port.readline().decode("ascii", "replace")
+            if not line:
+                break
+            lines.append(line)
+            if line.startswith("+SOAKDUMP:END"):
+                break
+        return lines
+
+
+def plot(samples):
+    import matplotlib.pyplot as plt
+    fig, axes = plt.subplots(4, 1, sharex=True)
+    index = list(range(len(samples)))
+    for axis, field, label in zip(axes, ("batt_mv", "rssi", "sats", "hdop"),
+                                  ("Battery mV", "RSSI dBm", "Satellites", "HDOP x100")):
+        axis.plot(index, [sample[field] for _, sample in samples], ".-")
+        axis.set_ylabel(label)
+    # Mark the segment starts
+    for idx in range(1, len(samples)):
+        if samples[idx][0] != samples[idx - 1][0]:
+            for axis in axes:
+                axis.axvline(idx, color="red", alpha=0.3)
+    axes[-1].set_xlabel("Sample (red line = new segment, reboot or new file)")
+    plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the soak test log of the WisBlock HW tester")
+    parser.add_argument("input", nargs="?", help="captured AT+SOAKDUMP output, stdin if omitted")
+    parser.add_argument("--port", help="read directly from a serial port (requires pyserial)")
+    parser.add_argument("--plot", action="store_true", help="plot the trend (requires matplotlib)")
+    args = parser.parse_args()
+
+    if args.port:
+        lines = read_port(args.port)
+    elif args.input:
+        with open(args.input) as f:
+            lines = f.readlines()
+    else:
+        lines = sys.stdin.readlines()
+
+    data = read_dump(lines)
+    samples = decode(data)
+    print("segment," + ",".join(FIELDS))
+    for segment, sample in samples:
+        print("%d,%s" % (segment, ",".join(str(sample[field]) for field in FIELDS)))
+    sys.stderr.write("%d bytes, %d samples, %.1f bytes per sample\n" %
+                     (len(data), len(samples), len(data) / max(len(samples), 1)))
+    if args.plot:
+        plot(samples)
+
+
+if __name__ == "__main__":
+    main()
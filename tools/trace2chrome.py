@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+# Convert the timeline dump of the trace build (APP_TRACE=1) into Chrome trace JSON
+#
+# Capture the USB output of the tester into a file, then
+#   python3 tools/trace2chrome.py capture.log trace.json
+# and open trace.json in chrome://tracing or https://ui.perfetto.dev
+#
+# Only lines starting with "TRACE," are used, all other log output is ignored.
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_EV_TASK_IN = 1
+TRACE_EV_ISR_ENTER = 2
+TRACE_EV_ISR_EXIT = 3
+TRACE_EV_ISR_GIVE = 4
+TRACE_EV_SPAN_BEGIN = 5
+TRACE_EV_SPAN_END = 6
+TRACE_EV_MARK = 7
+
+PID_CPU = 1
+PID_STAGES = 2
+PID_ISR = 3
+
+
+def parse_dump(lines):
+    clock_hz = 32768
+    tasks = {}
+    names = {}
+    raw = bytearray()
+    for line in lines:
+        line = line.strip()
+        if not line.startswith("TRACE,"):
+            continue
+        fields = line.split(",", 3)
+        if fields[1] == "BEGIN":
+            clock_hz = int(fields[2])
+            tasks.clear()
+            names.clear()
+            raw = bytearray()
+        elif fields[1] == "T":
+            tasks[int(fields[2])] = fields[3]
+        elif fields[1] == "S":
+            names[int(fields[2])] = fields[3]
+        elif fields[1] == "E":
+            raw += bytes.fromhex(fields[2])
+    events = [struct.unpack_from("<IBBH", raw, pos) for pos in range(0, len(raw) - 7, 8)]
+    return clock_hz, tasks, names, events
+
+
+def to_chrome(clock_hz, tasks, names, events):
+    out = []
+
+    def meta(pid, tid, kind, name):
+        out.append({"name": kind, "ph": "M", "pid": pid, "tid": tid, "args": {"name": name}})
+
+    meta(PID_CPU, 0, "process_name", "CPU")
+    meta(PID_CPU, 0, "thread_name", "running task")
+    meta(PID_STAGES, 0, "process_name", "Test stages")
+    meta(PID_ISR, 0, "process_name", "ISR")
+    for tid, name in tasks.items():
+        meta(PID_STAGES, tid, "thread_name", name)
+
+    if not events:
+        return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+    start = events[0][0]
+    current_task = 0
+    task_start = None
+
+    def ts(ticks):
+        return (ticks - start) * 1e6 / clock_hz
+
+    for time, ev_type, ev_id, arg in events:
+        if ev_type == TRACE_EV_TASK_IN:
+            if task_start is not None:
+                out.append({"name": tasks.get(current_task, "task %d" % current_task), "ph": "X",
+                            "pid": PID_CPU, "tid": 0, "ts": ts(task_start), "dur": ts(time) - ts(task_start)})
+            current_task = ev_id
+            task_start = time
+        elif ev_type == TRACE_EV_SPAN_BEGIN:
+            out.append({"name": names.get(ev_id, "span %d" % ev_id), "ph": "B",
+                        "pid": PID_STAGES, "tid": current_task, "ts": ts(time)})
+        elif ev_type == TRACE_EV_SPAN_END:
+            out.append({"name": names.get(ev_id, "span %d" % ev_id), "ph": "E",
+                        "pid": PID_STAGES, "tid": current_task, "ts": ts(time)})
+        elif ev_type == TRACE_EV_ISR_ENTER:
+            out.append({"name": "ISR %d" % ev_id, "ph": "B", "pid": PID_ISR, "tid": ev_id, "ts": ts(time)})
+        elif ev_type == TRACE_EV_ISR_EXIT:
+            out.append({"name": "ISR %d" % ev_id, "ph": "E", "pid": PID_ISR, "tid": ev_id, "ts": ts(time)})
+        elif ev_type == TRACE_EV_ISR_GIVE:
+            # ev_id is the exception number, IRQ number is exception number - 16
+            out.append({"name": "wake from IRQ %d" % (ev_id - 16), "ph": "i", "s": "g",
+                        "pid": PID_ISR, "tid": 0, "ts": ts(time)})
+        elif ev_type == TRACE_EV_MARK:
+            out.append({"name": names.get(ev_id, "mark %d" % ev_id), "ph": "i", "s": "g",
+                        "pid": PID_STAGES, "tid": current_task, "ts": ts(time), "args": {"value": arg}})
+
+    if task_start is not None:
+        end = events[-1][0]
+        out.append({"name": tasks.get(current_task, "task %d" % current_task), "ph": "X",
+                    "pid": PID_CPU, "tid": 0, "ts": ts(task_start), "dur": ts(end) - ts(task_start)})
+
+    return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert WisBlock HW tester trace dump to Chrome trace JSON")
+    parser.add_argument("input", help="captured USB log with the TRACE dump")
+    parser.add_argument("output", nargs="?", help="JSON output file, stdout if omitted")
+    args = parser.parse_args()
+
+    with open(args.input, "r", errors="replace") as f:
+        clock_hz, tasks, names, events = parse_dump(f)
+
+    result = to_chrome(clock_hz, tasks, names, events)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(result, f)
+        print("%d events written to %s" % (len(events), args.output))
+    else:
+        json.dump(result, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()